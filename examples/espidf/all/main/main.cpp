@@ -16,6 +16,7 @@
 #include <entities/HaEntityCover.h>
 #include <entities/HaEntityCurrent.h>
 #include <entities/HaEntityDeviceTrigger.h>
+#include <entities/HaEntityDiagnostics.h>
 #include <entities/HaEntityDoor.h>
 #include <entities/HaEntityEvent.h>
 #include <entities/HaEntityHumidity.h>
@@ -83,6 +84,7 @@ HaEntityCurrent _ha_entity_current(ha_bridge, "current", std::nullopt,
                                    {.unit = HaEntityCurrent::Unit::mA, .force_update = false});
 HaEntityDeviceTrigger _ha_entity_device_trigger(ha_bridge, "device_trigger",
                                                 {.type = "button_short_press", .subtype = "button_1"});
+HaEntityDiagnostics _ha_entity_diagnostics(ha_bridge, std::nullopt, {.update_interval_ms = 60000});
 HaEntityDoor _ha_entity_door(ha_bridge, "door", "");
 HaEntityEvent _ha_entity_event(ha_bridge, "event", "party",
                                {.event_types = {"button_press"}, .device_class = HaEntityEvent::DeviceClass::Button});
@@ -109,7 +111,7 @@ HaEntityPower _ha_entity_power(ha_bridge, "power", std::nullopt,
                                {.unit = HaEntityPower::Unit::W, .force_update = false});
 HaEntitySelect _ha_entity_select(ha_bridge, "select", "playlist", {.options = {"option1", "option2"}, .retain = false});
 HaEntitySound _ha_entity_sound(ha_bridge, "sound", "");
-homeassistantentities::Sensor::Precipitation _precipitation;
+constexpr homeassistantentities::Sensor::Precipitation _precipitation;
 HaEntitySensor _ha_entity_sensor(ha_bridge, "sensor", std::nullopt,
                                  HaEntitySensor::Configuration{
                                      .device_class = _precipitation,
@@ -154,20 +156,21 @@ void haStateTask(void *pvParameters) {
     _ha_entity_cover.publish(HaEntityCover::State::Opening, 50);
     _ha_entity_current.publishCurrent(10);
     _ha_entity_device_trigger.publishTrigger();
+    _ha_entity_diagnostics.loop();
     _ha_entity_door.publishDoor(true);
     _ha_entity_event.publishEvent("button_press", {{"attr1", "value1"}, {"attr2", "value2"}});
     _ha_entity_humidity.publishHumidity(55.0);
     _ha_entity_json.publishJson(jsn);
     _ha_entity_light.publishIsOn(true);
     _ha_entity_light.publishBrightness(255);
-    _ha_entity_light.publishEffect("effect");
+    _ha_entity_light.publishEffect("colorloop");
     _ha_entity_light.publishRgb(255, 255, 255);
     _ha_entity_lock.publishLock(true);
     _ha_entity_motion.publishMotion(true);
     _ha_entity_number.publishNumber(55.0);
     _ha_entity_particulate_matter.publishConcentration(55.0);
     _ha_entity_power.publishPower(10);
-    _ha_entity_select.publishSelection("option");
+    _ha_entity_select.publishSelection("option1");
     _ha_entity_sensor.publishValue(55.0);
     _ha_entity_sound.publishSound(true);
     _ha_entity_string.publishString("string", {{"attr1", "value1"}, {"attr2", "value2"}});
@@ -209,6 +212,7 @@ void app_main(void) {
       _ha_entity_cover.publishConfiguration();
       _ha_entity_current.publishConfiguration();
       _ha_entity_device_trigger.publishConfiguration();
+      _ha_entity_diagnostics.publishConfiguration();
       _ha_entity_door.publishConfiguration();
       _ha_entity_event.publishConfiguration();
       _ha_entity_humidity.publishConfiguration();
@@ -43,7 +43,7 @@ HaEntityTemperature _ha_entity_temperature_inside(ha_bridge, "temperature inside
 HaEntityTemperature _ha_entity_temperature_outside(ha_bridge, "temperature outside", "outside");
 
 // Precipitation sensor using the generic sensor, as there is no specific class for precipitation (yet).
-homeassistantentities::Sensor::Precipitation _precipitation;
+constexpr homeassistantentities::Sensor::Precipitation _precipitation;
 HaEntitySensor
     _ha_entity_generic_sensor(ha_bridge, "precipitation", std::nullopt,
                               {
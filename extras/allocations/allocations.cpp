@@ -0,0 +1,109 @@
+// Counts the heap allocations of the publish and update methods of the entities, on the host. Not part of the library,
+// for measuring changes to the hot paths.
+//
+// Build and run from the root of the repository, with nlohmann-json on the include path (one command line):
+//
+//   g++ -std=gnu++17 -O2 -Isrc -Isrc/entities -o allocations extras/allocations/allocations.cpp src/*.cpp
+//       src/entities/*.cpp -lpthread && ./allocations
+//
+// Each method is called once to warm up (like building cached topics), then the allocations are averaged over the next
+// calls. The MQTT remote drops all messages, so only allocations in this library are counted.
+#include <HaBridge.h>
+#include <HaEntityCover.h>
+#include <HaEntityEvent.h>
+#include <HaEntityFan.h>
+#include <HaEntityLight.h>
+#include <HaEntityNumber.h>
+#include <HaEntitySelect.h>
+#include <HaEntitySensorGroup.h>
+#include <HaEntityString.h>
+#include <HaEntitySwitch.h>
+#include <HaEntityText.h>
+#include <IMQTTRemote.h>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+static constexpr homeassistantentities::Sensor::Humidity humidity = {};
+
+void *operator new(size_t size) {
+  allocations++;
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+class NullRemote : public IMQTTRemote {
+public:
+  bool publishMessage(std::string, std::string, bool = false, uint8_t = 0) override { return true; }
+  bool publishMessageVerbose(std::string, std::string, bool = false, uint8_t = 0) override { return true; }
+  bool subscribe(std::string, SubscriptionCallback) override { return true; }
+  bool unsubscribe(std::string) override { return true; }
+  bool connected() override { return true; }
+  std::string &clientId() override { return _client_id; }
+
+private:
+  std::string _client_id = "client";
+};
+
+template <typename F> void measure(const char *name, F f) {
+  const int calls = 100;
+  f(0);
+  auto before = allocations;
+  for (int i = 1; i <= calls; i++) {
+    f(i);
+  }
+  printf("  %-48s %5.1f\n", name, static_cast<double>(allocations - before) / calls);
+}
+
+int main() {
+  NullRemote remote;
+  IJsonDocument device;
+  HaBridge bridge(remote, "node", device);
+
+  HaEntityString string(bridge, "string", "string", {.with_attributes = true});
+  HaEntityEvent event(bridge, "event", "event", {.event_types = {"pressed", "released"}});
+  HaEntitySensorGroup group(bridge, "group", {{.name = "humidity", .device_class = humidity}});
+  HaEntityText text(bridge, "text", "text", {.with_state_topic = true});
+  HaEntityFan fan(bridge, "fan", "fan", {.presets = {"eco", "boost"}});
+  HaEntityLight light(bridge, "light", "light", {.with_brightness = true, .effects = {"rainbow", "fire"}});
+  HaEntityCover cover(bridge, "cover", "cover");
+  HaEntityNumber number(bridge, "number", "number");
+  HaEntitySwitch switch_(bridge, "switch", "switch");
+  HaEntitySelect select(bridge, "select", "select", {.options = {"low", "high"}});
+
+  printf("Heap allocations per call:\n");
+  measure("HaEntityString::publishString(str, attrs)", [&](int i) {
+    string.publishString("a value longer than the small string buffer " + std::to_string(i),
+                         {{"attribute", "value"}, {"count", i}});
+  });
+  measure("HaEntityString::updateString(changed, attrs)", [&](int i) {
+    string.updateString("a value longer than the small string buffer " + std::to_string(i), {{"count", i}});
+  });
+  measure("HaEntityEvent::publishEvent(event, attrs)",
+          [&](int i) { event.publishEvent(i & 1 ? "pressed" : "released", {{"count", i}}); });
+  measure("HaEntitySensorGroup::publishValues", [&](int i) { group.publishValues({{"humidity", i}}); });
+  measure("HaEntityText::publishText", [&](int i) { text.publishText(std::to_string(i)); });
+  measure("HaEntityText::updateText(unchanged)", [&](int) { text.updateText("100"); });
+  measure("HaEntityFan::publishPreset", [&](int i) { fan.publishPreset(i & 1 ? "eco" : "boost"); });
+  measure("HaEntityFan::updatePreset(unchanged)", [&](int) { fan.updatePreset("boost"); });
+  measure("HaEntityLight::publishIsOn", [&](int i) { light.publishIsOn(i & 1); });
+  measure("HaEntityLight::publishBrightness", [&](int i) { light.publishBrightness(static_cast<uint8_t>(i)); });
+  measure("HaEntityLight::publishEffect", [&](int i) { light.publishEffect(i & 1 ? "fire" : "rainbow"); });
+  measure("HaEntityLight::updateIsOn(unchanged)", [&](int) { light.updateIsOn(false); });
+  measure("HaEntityCover::publish(state, position)", [&](int i) {
+    cover.publish(i & 1 ? HaEntityCover::State::Open : HaEntityCover::State::Closed, static_cast<uint8_t>(i));
+  });
+  measure("HaEntityCover::update(unchanged)", [&](int) { cover.update(HaEntityCover::State::Open, 1); });
+  measure("HaEntityNumber::publishNumber", [&](int i) { number.publishNumber(static_cast<float>(i)); });
+  measure("HaEntityNumber::updateNumber(unchanged)", [&](int) { number.updateNumber(5); });
+  measure("HaEntitySwitch::publishSwitch", [&](int i) { switch_.publishSwitch(i & 1); });
+  measure("HaEntitySwitch::updateSwitch(unchanged)", [&](int) { switch_.updateSwitch(false); });
+  measure("HaEntitySelect::publishSelection", [&](int i) { select.publishSelection(i & 1 ? "high" : "low"); });
+  measure("HaEntitySelect::updateSelection(unchanged)", [&](int) { select.updateSelection("low"); });
+  return 0;
+}
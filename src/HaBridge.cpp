@@ -1,68 +1,336 @@
 #include "HaBridge.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <optional>
 
 using namespace homeassistantentities;
 
+// The topic alias property of an MQTT 5 publish: identifier and 2 byte alias.
+static constexpr size_t TOPIC_ALIAS_BYTES = 3;
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+struct HaBridge::DiscoveryArena {
+  DiscoveryArena(std::pmr::memory_resource *upstream_resource, size_t arena_size)
+      : upstream(upstream_resource), size(arena_size), buffer(upstream_resource->allocate(arena_size)),
+        arena(buffer, arena_size, upstream_resource) {}
+  ~DiscoveryArena() {
+    arena.release();
+    upstream->deallocate(buffer, size);
+  }
+
+  std::pmr::memory_resource *upstream;
+  size_t size;
+  void *buffer;
+  std::pmr::monotonic_buffer_resource arena;
+};
+
+#ifdef IJSON_SUPPORTS_ALLOCATOR
+/**
+ * @brief IJsonAllocator on top of a std::pmr::memory_resource. The JSON library does not pass the size when freeing,
+ * so it is stored in front of each block.
+ */
+class MemoryResourceJsonAllocator : public IJsonAllocator {
+public:
+  MemoryResourceJsonAllocator(std::pmr::memory_resource *resource) : _resource(resource) {}
+
+  void *allocate(size_t size) override {
+    auto block = static_cast<char *>(_resource->allocate(size + HEADER_SIZE, alignof(std::max_align_t)));
+    *reinterpret_cast<size_t *>(block) = size;
+    return block + HEADER_SIZE;
+  }
+
+  void deallocate(void *ptr) override {
+    if (ptr != nullptr) {
+      auto block = static_cast<char *>(ptr) - HEADER_SIZE;
+      _resource->deallocate(block, *reinterpret_cast<size_t *>(block) + HEADER_SIZE, alignof(std::max_align_t));
+    }
+  }
+
+  void *reallocate(void *ptr, size_t new_size) override {
+    void *new_ptr = allocate(new_size);
+    if (ptr != nullptr) {
+      auto old_size = *reinterpret_cast<size_t *>(static_cast<char *>(ptr) - HEADER_SIZE);
+      std::memcpy(new_ptr, ptr, std::min(old_size, new_size));
+      deallocate(ptr);
+    }
+    return new_ptr;
+  }
+
+private:
+  static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+  std::pmr::memory_resource *_resource;
+};
+#endif
+#endif
+
 HaBridge::HaBridge(IMQTTRemote &remote, std::string node_id, IJsonDocument &this_device_json_doc, bool verbose,
                    std::function<std::string(IMQTTRemote &)> availability_topic,
                    std::function<std::string(IMQTTRemote &, std::string &)> unique_id)
-    : _verbose(verbose), _node_id(node_id), _remote(remote), _this_device_json_doc(this_device_json_doc),
+    : _verbose(verbose), _node_id(node_id), _node_id_path(santitizePath(node_id)), _remote(remote),
+      _remote_adapter(remote), _remote_extended(&_remote_adapter), _this_device_json_doc(this_device_json_doc),
       _availability_topic(availability_topic), _unique_id(unique_id) {}
 
-void HaBridge::publishConfiguration(std::string component, std::string object_id, std::string child_object_id,
-                                    const IJsonDocument &specific_doc) {
-  IJsonDocument doc;
-  doc["availability_topic"] =
-      _availability_topic ? _availability_topic(_remote) : (santitizePath(_remote.clientId()) + "/status");
+HaBridge::~HaBridge() = default;
 
-  std::string unique_id = _unique_id ? _unique_id(_remote, _node_id) : (_remote.clientId() + "_" + _node_id);
+#ifdef HA_HAS_MEMORY_RESOURCE
+bool HaBridge::setMemoryResource(std::pmr::memory_resource *resource, size_t discovery_arena_size) {
+  _memory_resource = resource;
+#ifdef IJSON_SUPPORTS_ALLOCATOR
+  _discovery_arena.reset();
+  if (discovery_arena_size > 0) {
+    _discovery_arena = std::make_unique<DiscoveryArena>(
+        resource != nullptr ? resource : std::pmr::new_delete_resource(), discovery_arena_size);
+  }
+  return true;
+#else
+  // Only the publish queue uses the resource, this JSON library can not allocate the discovery documents from it.
+  return false;
+#endif
+}
+#endif
 
-  auto coid = homeassistantentities::trim(child_object_id);
+void HaBridge::publishConfiguration(std::string_view component, std::string_view object_id,
+                                    std::string_view child_object_id, const IJsonDocument &specific_doc) {
+  auto start = std::chrono::steady_clock::now();
+
+  std::string unique_id = _unique_id ? _unique_id(_remote, _node_id) : (_remote.clientId() + "_" + _node_id);
+  auto coid = homeassistantentities::trimView(child_object_id);
   if (!coid.empty()) {
-    unique_id += "_" + coid;
+    unique_id += '_';
+    unique_id += coid;
   }
-  unique_id += "_" + object_id;
-  doc["unique_id"] = unique_id;
+  unique_id += '_';
+  unique_id += object_id;
 
-  // Set optional device keys.
-  for (auto kv : IJsonIteratorBegin(_this_device_json_doc)) {
-    doc["device"][kv.key()] = kv.value();
-  }
+  std::string message;
+  {
+#if defined(HA_HAS_MEMORY_RESOURCE) && defined(IJSON_SUPPORTS_ALLOCATOR)
+    std::optional<MemoryResourceJsonAllocator> allocator;
+    if (_discovery_arena) {
+      allocator.emplace(&_discovery_arena->arena);
+    } else if (_memory_resource != nullptr) {
+      allocator.emplace(_memory_resource);
+    }
+    IJsonDocument doc = allocator ? IJsonDocument(&*allocator) : IJsonDocument();
+#else
+    IJsonDocument doc;
+#endif
+    doc["availability_topic"] =
+        _availability_topic ? _availability_topic(_remote) : (santitizePath(_remote.clientId()) + "/status");
+    doc["unique_id"] = unique_id;
+
+    // Set optional device keys.
+    for (auto kv : IJsonIteratorBegin(_this_device_json_doc)) {
+      doc["device"][kv.key()] = kv.value();
+    }
 
-  for (auto kv : IJsonConstIteratorBegin(specific_doc)) {
-    doc[kv.key()] = kv.value();
+    for (auto kv : IJsonConstIteratorBegin(specific_doc)) {
+      doc[kv.key()] = kv.value();
+    }
+
+    message = toJsonString(doc);
+  }
+#ifdef HA_HAS_MEMORY_RESOURCE
+  if (_discovery_arena) {
+    // The document is gone, so everything in the arena can be reused for the next one.
+    _discovery_arena->arena.release();
   }
+#endif
 
-  auto message = toJsonString(doc);
-  std::string topic =
-      "homeassistant/" + santitizePath(component) + "/" + santitizePath(_node_id) + "/" + santitizePath(object_id);
+  std::string topic = "homeassistant/";
+  appendSantitizedPath(topic, component);
+  topic += '/';
+  topic += _node_id_path;
+  topic += '/';
+  appendSantitizedPath(topic, object_id);
   if (!coid.empty()) {
-    topic += "_" + coid;
+    topic += '_';
+    topic += coid;
   }
   topic += "/config";
+  if (_discovery_fingerprint) {
+    _discovery_fingerprint = fnv1a(message, fnv1a(topic, *_discovery_fingerprint));
+    return;
+  }
   publishMessage(topic, message, true);
+
+  auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  _metrics.recordDiscovery(static_cast<uint32_t>(duration_us.count()));
+}
+
+uint32_t HaBridge::endDiscoveryFingerprint() {
+  auto fingerprint = _discovery_fingerprint.value_or(0);
+  _discovery_fingerprint.reset();
+  return fingerprint;
+}
+
+bool HaBridge::publishMessage(std::string_view topic, std::string_view message, bool retain) {
+  if (_retain_state || _state_filter) {
+    HaBridgeMetrics::TopicType topic_type;
+    HaBridgeMetrics::Component component;
+    HaBridgeMetrics::classify(topic, topic_type, component);
+    // Events are not states. A retained event would fire again each time Home Assistant subscribes, and the same event
+    // twice is not a duplicate.
+    bool state = topic_type == HaBridgeMetrics::TopicType::State && component != HaBridgeMetrics::Component::Event;
+    if (state && _state_filter && !_state_filter(topic, message)) {
+      _metrics.recordDeduplicated(component);
+      return true;
+    }
+    retain = retain || (_retain_state && state);
+  }
+
+  if (!_publish_queue) {
+    return publishNow(topic, message, retain);
+  }
+
+  auto bytes = topic.size() + message.size();
+  if (_publish_queue->push(topic, message, retain)) {
+    _metrics.setQueueDepth(static_cast<uint32_t>(_publish_queue->size()));
+    return true;
+  }
+
+  // Dropped, count as a failed publish.
+  HaBridgeMetrics::TopicType topic_type;
+  HaBridgeMetrics::Component component;
+  HaBridgeMetrics::classify(topic, topic_type, component);
+  _metrics.recordPublish(topic_type, component, bytes, false, 0);
+  if (_state_observer && topic_type == HaBridgeMetrics::TopicType::State &&
+      component != HaBridgeMetrics::Component::Event) {
+    _state_observer(topic, message, false);
+  }
+  return false;
+}
+
+void HaBridge::setPublishQueue(size_t capacity) {
+#ifdef HA_HAS_MEMORY_RESOURCE
+  _publish_queue = std::make_unique<HaPublishQueue>(capacity, _memory_resource);
+#else
+  _publish_queue = std::make_unique<HaPublishQueue>(capacity);
+#endif
+}
+
+size_t HaBridge::publishQueued(size_t max_messages) {
+  if (!_publish_queue) {
+    return 0;
+  }
+
+  size_t count = 0;
+  while (count < max_messages) {
+    auto message = _publish_queue->pop();
+    if (!message) {
+      break;
+    }
+    publishNow(message->topic, message->message, message->retain);
+    count++;
+  }
+  _metrics.setQueueDepth(static_cast<uint32_t>(_publish_queue->size()));
+  return count;
+}
+
+bool HaBridge::subscribe(std::string topic, IMQTTRemote::SubscriptionCallback callback, bool coalesce) {
+  if (_command_queue) {
+    return _remote.subscribe(topic, _command_queue->wrap(callback, coalesce));
+  }
+  return _remote.subscribe(topic, callback);
+}
+
+bool HaBridge::unsubscribe(const std::string &topic) {
+  auto result = _remote.unsubscribe(topic);
+  if (_command_queue) {
+    _command_queue->discard(topic);
+  }
+  return result;
+}
+
+void HaBridge::setCommandQueue(size_t capacity) {
+  // Subscriptions already made refer to the existing queue, so it can not be replaced.
+  if (!_command_queue) {
+    _command_queue = std::make_unique<HaCommandQueue>(capacity);
+  }
 }
 
-bool HaBridge::publishMessage(std::string topic, std::string message, bool retain) {
+size_t HaBridge::dispatchCommands(size_t max_commands) {
+  return _command_queue ? _command_queue->dispatch(max_commands) : 0;
+}
+
+bool HaBridge::publishNow(std::string_view topic, std::string_view message, bool retain) {
+  HaBridgeMetrics::TopicType topic_type;
+  HaBridgeMetrics::Component component;
+  HaBridgeMetrics::classify(topic, topic_type, component);
+  auto bytes = topic.size() + message.size();
+
+  auto start = std::chrono::steady_clock::now();
+  bool success;
   if (_verbose) {
-    return _remote.publishMessageVerbose(topic, message, retain);
-  } else {
-    return _remote.publishMessage(topic, message, retain);
+    success = _remote_extended->publishVerbose(topic, message, retain);
+  } else if (topic_type != HaBridgeMetrics::TopicType::State || !publishAliased(topic, message, retain, success)) {
+    success = _remote_extended->publish(topic, message, retain);
+  }
+  auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  _metrics.recordPublish(topic_type, component, bytes, success, static_cast<uint32_t>(latency_us.count()));
+  if (_state_observer && topic_type == HaBridgeMetrics::TopicType::State &&
+      component != HaBridgeMetrics::Component::Event) {
+    _state_observer(topic, message, success);
+  }
+  return success;
+}
+
+void HaBridge::setTopicAliases(IMQTTRemoteTopicAlias &remote_topic_alias, uint16_t max_aliases) {
+  _remote_topic_alias = &remote_topic_alias;
+  _topic_aliases = std::make_unique<HaTopicAliases>(max_aliases);
+}
+
+bool HaBridge::publishAliased(std::string_view topic, std::string_view message, bool retain, bool &success) {
+  if (!_topic_aliases) {
+    return false;
+  }
+
+  // The broker forgets the aliases when disconnected, and might accept another number of them after a reconnect.
+  auto connection = _remote_topic_alias->connectionNumber();
+  if (!_topic_aliases->isCurrent(connection)) {
+    _topic_aliases->reset(connection, _remote_topic_alias->topicAliasMaximum());
+  }
+
+  bool assigned;
+  auto alias = _topic_aliases->alias(topic, assigned);
+  if (alias == 0) {
+    return false;
+  }
+
+  success = _remote_topic_alias->publishAliased(assigned ? topic : std::string_view(), alias, message, retain);
+  if (!success && assigned) {
+    // The broker might not have got the assignment, so the alias can not be used without the topic.
+    _topic_aliases->forget(alias);
+  } else if (success && !assigned && topic.size() > TOPIC_ALIAS_BYTES) {
+    _metrics.recordTopicAliasSaved(static_cast<uint32_t>(topic.size() - TOPIC_ALIAS_BYTES));
   }
+  return true;
 }
 
-std::string HaBridge::getTopic(TopicType topic_type, std::string component, std::string object_id,
-                               std::string child_object_id) {
-  auto str = santitizePath(_node_id) + "/" + santitizePath(component) + "/" + santitizePath(object_id);
+std::string HaBridge::getTopic(TopicType topic_type, std::string_view component, std::string_view object_id,
+                               std::string_view child_object_id) {
+  auto coid = trimView(child_object_id);
+  auto type = topicType(topic_type);
 
-  auto coid = trim(child_object_id);
+  std::string str;
+  str.reserve(_node_id_path.size() + component.size() + object_id.size() + coid.size() + type.size() + 4);
+  str += _node_id_path;
+  str += '/';
+  appendSantitizedPath(str, component);
+  str += '/';
+  appendSantitizedPath(str, object_id);
   if (!coid.empty()) {
-    str += "/" + santitizePath(coid);
+    str += '/';
+    appendSantitizedPath(str, coid);
   }
-  str += "/" + santitizePath(topicType(topic_type));
+  str += '/';
+  str += type;
   return str;
 }
 
-std::string HaBridge::topicType(TopicType topic_type) {
+std::string_view HaBridge::topicType(TopicType topic_type) {
   switch (topic_type) {
   case TopicType::State:
     return "state";
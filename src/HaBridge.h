@@ -1,12 +1,24 @@
 #ifndef __HA_BRIDGE_H__
 #define __HA_BRIDGE_H__
 
+#include <HaBridgeMetrics.h>
+#include <HaCommandQueue.h>
+#include <HaPublishQueue.h>
+#include <HaSpinLock.h>
+#include <HaTopicAliases.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 #include <IMQTTRemote.h>
+#include <IMQTTRemoteExtended.h>
+#include <IMQTTRemoteTopicAlias.h>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Bridge for MQTT and Home Assistant.
@@ -42,6 +54,7 @@ public:
   HaBridge(IMQTTRemote &remote, std::string node_id, IJsonDocument &this_device_json_doc, bool verbose = false,
            std::function<std::string(IMQTTRemote &remote)> availability_topic = {},
            std::function<std::string(IMQTTRemote &remote, std::string &node_id)> unique_id = {});
+  ~HaBridge();
 
 public:
   /**
@@ -69,19 +82,139 @@ public:
    * are [a-zA-Z0-9_-] (machine readable, not human readable)
    * @param specific_doc Any entity specific values. See brief documentation.
    */
-  void publishConfiguration(std::string component, std::string object_id, std::string child_object_id,
-                            const IJsonDocument &specific_doc);
+  void publishConfiguration(std::string_view component, std::string_view object_id,
+                            std::string_view child_object_id, const IJsonDocument &specific_doc);
 
   /**
-   * @brief Publish a message.
+   * @brief Publish a message. In queued mode (see setPublishQueue()), the message is added to the queue instead.
+   * Takes views, so fixed payloads like "ON" and topics kept by the entities are not copied on the way.
    *
    * @param topic the topic to publish to.
    * @param message The message to send. This cannot be larger than the value set for max_message_size in the
    * constructor.
    * @param retain True to set this message as retained.
-   * @returns true on success, or false on failure.
+   * @returns true on success, or false on failure. In queued mode, true if the message was queued and false if the
+   * queue is full.
    */
-  bool publishMessage(std::string topic, std::string message, bool retain = false);
+  bool publishMessage(std::string_view topic, std::string_view message, bool retain = false);
+
+  /**
+   * @brief Publish a state of an entity, and store it in the state cache of the entity with store(). In queued mode
+   * (see setPublishQueue()), lock is held across queueing the message and store(), so when several tasks publish a
+   * state of the same entity, the message queued last is also the one in the cache. Without a queue, the message is
+   * published first and store() runs under lock afterwards, as the lock can not be held while the MQTT client sends.
+   *
+   * @param lock the lock of the state cache, usually the lock of the entity.
+   * @param store stores the state in the cache. Can move from what message refers to, which is not used after.
+   * @returns the result from publishMessage().
+   */
+  template <typename Store>
+  bool publishState(homeassistantentities::SpinLock &lock, std::string_view topic, std::string_view message,
+                    Store store) {
+    if (_publish_queue) {
+      std::lock_guard<homeassistantentities::SpinLock> guard(lock);
+      auto result = publishMessage(topic, message);
+      store();
+      return result;
+    }
+    auto result = publishMessage(topic, message);
+    std::lock_guard<homeassistantentities::SpinLock> guard(lock);
+    store();
+    return result;
+  }
+
+  /**
+   * @brief Republish a state from the state cache of an entity. load() runs under lock and returns the message (an
+   * optional std::string, or std::string_view to a literal), or std::nullopt if there is no state yet. In queued mode,
+   * lock is held until the message is queued, so the republish can not overtake a newer state published with
+   * publishState() from another task.
+   *
+   * @param lock the lock of the state cache, usually the lock of the entity.
+   * @returns the result from publishMessage(), or true if there was no state.
+   */
+  template <typename Load>
+  bool republishState(homeassistantentities::SpinLock &lock, std::string_view topic, Load load) {
+    if (_publish_queue) {
+      std::lock_guard<homeassistantentities::SpinLock> guard(lock);
+      auto message = load();
+      return !message || publishMessage(topic, *message);
+    }
+    decltype(load()) message;
+    {
+      std::lock_guard<homeassistantentities::SpinLock> guard(lock);
+      message = load();
+    }
+    return !message || publishMessage(topic, *message);
+  }
+
+  /**
+   * @brief Publish all messages on state topics (see TopicType) as retained, so the broker keeps the last state of each
+   * entity. Needed for a warm start, see HaEntityRegistry. Events (HaEntityEvent) are never retained. Default is not
+   * retained.
+   */
+  void setRetainState(bool retain_state) { _retain_state = retain_state; }
+
+  /**
+   * @brief If messages on state topics are published as retained, see setRetainState().
+   */
+  bool retainState() const { return _retain_state; }
+
+  /**
+   * @brief Set a function called before publishing a message on a state topic (except events). Return false to not
+   * publish the message, which is then counted as a suppressed duplicate. Used by the battery mode of
+   * HaEntityRegistry to skip states already published before deep sleep.
+   *
+   * @param filter the filter, or an empty function for none (default).
+   */
+  void setStateFilter(std::function<bool(std::string_view topic, std::string_view message)> filter) {
+    _state_filter = filter;
+  }
+
+  /**
+   * @brief Set a function called after a message on a state topic (except events) was handed to the MQTT client, with
+   * the result. In queued mode (see setPublishQueue()), called when the message leaves the queue, or with false if the
+   * queue was full. Not called for messages dropped by the state filter. Used by HaEntityRegistry to republish states
+   * that could not be published, like while disconnected.
+   *
+   * @param observer the observer, or an empty function for none (default).
+   */
+  void setStateObserver(std::function<void(std::string_view topic, std::string_view message, bool success)> observer) {
+    _state_observer = observer;
+  }
+
+  /**
+   * @brief Start a discovery fingerprint. Until endDiscoveryFingerprint(), publishConfiguration() does not publish,
+   * but adds the topic and the configuration to a hash. Used by the battery mode of HaEntityRegistry to only publish
+   * the configurations if they changed. Not thread safe, no other task should publish configurations meanwhile.
+   */
+  void beginDiscoveryFingerprint() { _discovery_fingerprint = homeassistantentities::fnv1a({}); }
+
+  /**
+   * @brief End the discovery fingerprint started with beginDiscoveryFingerprint().
+   *
+   * @returns the hash of all configurations "published" since beginDiscoveryFingerprint().
+   */
+  uint32_t endDiscoveryFingerprint();
+
+  /**
+   * @brief Enable queued publishing, for when entities are updated from other tasks than the one owning the MQTT
+   * client. All messages, including configurations, are put in a lock-free queue (see HaPublishQueue.h) and published
+   * by publishQueued(), which should be called regularly from the task owning the MQTT client. Entities can then be
+   * updated from any task, also the same entity from several tasks (see publishState()). Call once, before any entity
+   * publishes.
+   *
+   * @param capacity maximum number of messages waiting to be published. Messages published when the queue is full are
+   * dropped and counted as failures in metrics().
+   */
+  void setPublishQueue(size_t capacity);
+
+  /**
+   * @brief In queued mode, publish messages from the queue. Call from the task owning the MQTT client.
+   *
+   * @param max_messages maximum number of messages to publish in this call.
+   * @returns the number of messages taken from the queue.
+   */
+  size_t publishQueued(size_t max_messages = SIZE_MAX);
 
   enum class TopicType {
     State,      // Usually when the entity post a state for the entity.
@@ -104,25 +237,142 @@ public:
    * ""door/binary_sensor/lock/upper/state". Valid characters
    * are [a-zA-Z0-9_-] (machine readable, not human readable)
    */
-  std::string getTopic(TopicType topic_type, std::string component, std::string object_id,
-                       std::string child_object_id = "");
+  std::string getTopic(TopicType topic_type, std::string_view component, std::string_view object_id,
+                       std::string_view child_object_id = {});
+
+  /**
+   * @brief Subscribe to a topic, usually a command topic. Entities use this rather than IMQTTRemote::subscribe(), so
+   * that the callback can be deferred with setCommandQueue().
+   *
+   * @param topic the topic to subscribe to.
+   * @param callback called with the topic and the message.
+   * @param coalesce if the command queue is enabled, only keep the latest pending message for this topic. Set to false
+   * if every message matters, like button presses.
+   * @returns the result from IMQTTRemote::subscribe().
+   */
+  bool subscribe(std::string topic, IMQTTRemote::SubscriptionCallback callback, bool coalesce = true);
+
+  /**
+   * @brief Unsubscribe from a topic subscribed to with subscribe(). Pending commands for the topic (see
+   * setCommandQueue()) are dropped.
+   *
+   * @param topic the topic to unsubscribe from.
+   * @returns the result from IMQTTRemote::unsubscribe().
+   */
+  bool unsubscribe(const std::string &topic);
 
   /**
-   * @brief Raw IMQTTRemote. Usually only needed for subscription. Otherwise use publishConfiguration() and
-   * publishMessage defined here).
+   * @brief Defer command callbacks (like HaEntityLight::setOnBrightness()) off the MQTT receive task. Messages for
+   * subscriptions done with subscribe() after this call are put in a bounded queue, and the callbacks are run when
+   * dispatchCommands() is called from a task of your choice. See HaCommandQueue.h. Only the first call has any
+   * effect, so call once before the entities subscribe.
+   *
+   * @param capacity maximum number of pending commands. Commands arriving when full are dropped.
+   */
+  void setCommandQueue(size_t capacity);
+
+  /**
+   * @brief Run the callbacks for pending commands, if setCommandQueue() has been called. Call regularly from the task
+   * that should run the callbacks.
+   *
+   * @param max_commands maximum number of commands to run in this call.
+   * @returns the number of callbacks run.
+   */
+  size_t dispatchCommands(size_t max_commands = SIZE_MAX);
+
+  /**
+   * @brief Raw IMQTTRemote. Usually not needed, use publishConfiguration(), publishMessage() and subscribe() defined
+   * here.
    */
   IMQTTRemote &remote() { return _remote; }
 
+  /**
+   * @brief Publish through remote_extended instead of IMQTTRemote::publishMessage(), so topics and messages are passed
+   * as views all the way to the MQTT client instead of being copied into std::string. Subscriptions still use the
+   * IMQTTRemote. See IMQTTRemoteExtended.h.
+   *
+   * @param remote_extended usually the same MQTT client as the IMQTTRemote. Must outlive the bridge.
+   */
+  void setRemoteExtended(IMQTTRemoteExtended &remote_extended) { _remote_extended = &remote_extended; }
+
+  /**
+   * @brief Publish states with MQTT 5 topic aliases through remote_topic_alias, when the broker supports them. The
+   * most recently published state topics get an alias (see HaTopicAliases.h), and later publishes to them carry the 2
+   * byte alias instead of the topic. Other topics, and all topics in verbose mode, are published as usual. The bytes
+   * saved are in HaBridgeMetrics::topicAliasSavedBytes().
+   *
+   * The message assigning an alias must reach the client before the messages using it, so all publishes must be from
+   * one task. With entities updated from several tasks, use setPublishQueue().
+   *
+   * @param remote_topic_alias usually the same MQTT client as the IMQTTRemote. Must outlive the bridge.
+   * @param max_aliases the most aliases to use, if the broker accepts that many. Each keeps a copy of its topic.
+   */
+  void setTopicAliases(IMQTTRemoteTopicAlias &remote_topic_alias, uint16_t max_aliases = 16);
+
+  /**
+   * @brief Publish metrics for this bridge, like number of messages, bytes, failures and publish latency. Can be read
+   * from any task. See HaBridgeMetrics.h.
+   */
+  HaBridgeMetrics &metrics() { return _metrics; }
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+  /**
+   * @brief Set where the bridge allocates its transient buffers from, for example a resource using PSRAM. Call before
+   * setPublishQueue().
+   *
+   * In queued mode (see setPublishQueue()), the topic and message of every queued message are allocated from the
+   * resource. With ArduinoJson, so is the JSON document built in publishConfiguration(): a buffer of
+   * discovery_arena_size bytes is allocated once from the resource and used as a bump arena for the document. The
+   * arena is reset after each publishConfiguration(), and falls back to the resource if a document does not fit.
+   *
+   * The state cached in the entities (like sensor values and attributes), topics and the strings handed to IMQTTRemote
+   * stay on the global heap. For entity names and object IDs, see
+   * homeassistantentities::StringPool::setMemoryResource().
+   *
+   * @param resource the resource to use, or nullptr for the global heap (default). Must outlive the bridge.
+   * @param discovery_arena_size size of the arena for discovery documents, or 0 for no arena.
+   * @returns true if the discovery documents use the resource too, or false if the JSON library does not support
+   * custom allocators (nlohmann-json, only ArduinoJson does), in which case only the publish queue uses it.
+   */
+  bool setMemoryResource(std::pmr::memory_resource *resource, size_t discovery_arena_size = 1024);
+
+  /**
+   * @brief The resource set with setMemoryResource(), or nullptr if none.
+   */
+  std::pmr::memory_resource *memoryResource() { return _memory_resource; }
+#endif
+
 private:
-  std::string topicType(TopicType topic_type);
+  std::string_view topicType(TopicType topic_type);
+  bool publishNow(std::string_view topic, std::string_view message, bool retain);
+  bool publishAliased(std::string_view topic, std::string_view message, bool retain, bool &success);
 
 private:
   bool _verbose;
+  bool _retain_state = false;
+  std::function<bool(std::string_view, std::string_view)> _state_filter;
+  std::function<void(std::string_view, std::string_view, bool)> _state_observer;
+  std::optional<uint32_t> _discovery_fingerprint;
   std::string _node_id;
+  std::string _node_id_path; // _node_id, santitized for use in topics.
   IMQTTRemote &_remote;
+  MQTTRemoteExtendedAdapter _remote_adapter;
+  IMQTTRemoteExtended *_remote_extended; // _remote_adapter, or what was set with setRemoteExtended().
   IJsonDocument &_this_device_json_doc;
   std::function<std::string(IMQTTRemote &)> _availability_topic;
   std::function<std::string(IMQTTRemote &, std::string &)> _unique_id;
+  HaBridgeMetrics _metrics;
+  std::unique_ptr<HaPublishQueue> _publish_queue;
+  std::unique_ptr<HaCommandQueue> _command_queue;
+  IMQTTRemoteTopicAlias *_remote_topic_alias = nullptr;
+  std::unique_ptr<HaTopicAliases> _topic_aliases;
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+private:
+  struct DiscoveryArena;
+  std::pmr::memory_resource *_memory_resource = nullptr;
+  std::unique_ptr<DiscoveryArena> _discovery_arena;
+#endif
 };
 
 #endif // __HA_BRIDGE_H__
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "HaBridgeMetrics.h"
+
+#define CONFIGURATION_PREFIX "homeassistant/"
+
+void HaBridgeMetrics::recordPublish(TopicType topic_type, Component component, size_t bytes, bool success,
+                                    uint32_t latency_us) {
+  for (auto *counters : {&_by_topic_type[static_cast<size_t>(topic_type)],
+                         &_by_component[static_cast<size_t>(component)]}) {
+    counters->messages.fetch_add(1, std::memory_order_relaxed);
+    counters->bytes.fetch_add(static_cast<uint32_t>(bytes), std::memory_order_relaxed);
+    if (!success) {
+      counters->failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  size_t bucket = 0;
+  while (bucket < LATENCY_BUCKET_BOUNDS_US.size() && latency_us > LATENCY_BUCKET_BOUNDS_US[bucket]) {
+    bucket++;
+  }
+  _latency_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  updateMax(_max_latency_us, latency_us);
+  updateMax(_max_message_bytes, static_cast<uint32_t>(bytes));
+}
+
+void HaBridgeMetrics::recordDeduplicated(Component component) {
+  _by_component[static_cast<size_t>(component)].deduplicated.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HaBridgeMetrics::recordDiscovery(uint32_t duration_us) {
+  _discovery_us.fetch_add(duration_us, std::memory_order_relaxed);
+}
+
+HaBridgeMetrics::Counters HaBridgeMetrics::total() const {
+  // Sum components rather than topic types, as deduplicated is only tracked per component.
+  Counters total;
+  for (const auto &counters : _by_component) {
+    auto c = counters.load();
+    total.messages += c.messages;
+    total.bytes += c.bytes;
+    total.failures += c.failures;
+    total.deduplicated += c.deduplicated;
+  }
+  return total;
+}
+
+HaBridgeMetrics::Counters HaBridgeMetrics::byTopicType(TopicType topic_type) const {
+  return _by_topic_type[static_cast<size_t>(topic_type)].load();
+}
+
+HaBridgeMetrics::Counters HaBridgeMetrics::byComponent(Component component) const {
+  return _by_component[static_cast<size_t>(component)].load();
+}
+
+uint32_t HaBridgeMetrics::latencyBucket(size_t bucket) const {
+  if (bucket >= _latency_buckets.size()) {
+    return 0;
+  }
+  return _latency_buckets[bucket].load(std::memory_order_relaxed);
+}
+
+void HaBridgeMetrics::reset() {
+  for (auto &counters : _by_topic_type) {
+    counters.reset();
+  }
+  for (auto &counters : _by_component) {
+    counters.reset();
+  }
+  for (auto &bucket : _latency_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  _max_latency_us.store(0, std::memory_order_relaxed);
+  _max_message_bytes.store(0, std::memory_order_relaxed);
+  _discovery_us.store(0, std::memory_order_relaxed);
+  _topic_alias_saved_bytes.store(0, std::memory_order_relaxed);
+}
+
+void HaBridgeMetrics::classify(std::string_view topic, TopicType &topic_type, Component &component) {
+  topic_type = TopicType::Other;
+  component = Component::Other;
+
+  std::string_view prefix = CONFIGURATION_PREFIX;
+  bool is_configuration = topic.substr(0, prefix.size()) == prefix;
+  if (is_configuration) {
+    topic.remove_prefix(prefix.size());
+  } else {
+    // Skip node ID.
+    auto first = topic.find('/');
+    if (first == std::string_view::npos) {
+      return;
+    }
+    topic.remove_prefix(first + 1);
+  }
+
+  auto slash = topic.find('/');
+  if (slash == std::string_view::npos) {
+    return;
+  }
+  component = HaBridgeMetrics::component(topic.substr(0, slash));
+
+  auto last_segment = topic.substr(topic.rfind('/') + 1);
+  if (is_configuration) {
+    topic_type = last_segment == "config" ? TopicType::Configuration : TopicType::Other;
+  } else if (last_segment == "state") {
+    topic_type = TopicType::State;
+  } else if (last_segment == "command") {
+    topic_type = TopicType::Command;
+  } else if (last_segment == "attributes") {
+    topic_type = TopicType::Attributes;
+  }
+}
+
+HaBridgeMetrics::Component HaBridgeMetrics::component(std::string_view component) {
+  if (component == "sensor") {
+    return Component::Sensor;
+  } else if (component == "binary_sensor") {
+    return Component::BinarySensor;
+  } else if (component == "button") {
+    return Component::Button;
+  } else if (component == "cover") {
+    return Component::Cover;
+  } else if (component == "device_automation") {
+    return Component::DeviceAutomation;
+  } else if (component == "event") {
+    return Component::Event;
+  } else if (component == "fan") {
+    return Component::Fan;
+  } else if (component == "light") {
+    return Component::Light;
+  } else if (component == "number") {
+    return Component::Number;
+  } else if (component == "select") {
+    return Component::Select;
+  } else if (component == "switch") {
+    return Component::Switch;
+  } else if (component == "text") {
+    return Component::Text;
+  }
+  return Component::Other;
+}
+
+HaBridgeMetrics::Counters HaBridgeMetrics::AtomicCounters::load() const {
+  return Counters{
+      .messages = messages.load(std::memory_order_relaxed),
+      .bytes = bytes.load(std::memory_order_relaxed),
+      .failures = failures.load(std::memory_order_relaxed),
+      .deduplicated = deduplicated.load(std::memory_order_relaxed),
+  };
+}
+
+void HaBridgeMetrics::AtomicCounters::reset() {
+  messages.store(0, std::memory_order_relaxed);
+  bytes.store(0, std::memory_order_relaxed);
+  failures.store(0, std::memory_order_relaxed);
+  deduplicated.store(0, std::memory_order_relaxed);
+}
+
+void HaBridgeMetrics::updateMax(std::atomic<uint32_t> &max, uint32_t value) {
+  auto current = max.load(std::memory_order_relaxed);
+  while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
@@ -0,0 +1,188 @@
+#ifndef __HA_BRIDGE_METRICS_H__
+#define __HA_BRIDGE_METRICS_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Lightweight publish metrics for a HaBridge. All counters are relaxed atomics, so they can be read from any
+ * task while the bridge is publishing. Counters are 32 bit and will wrap around on overflow.
+ *
+ * Every publish done through HaBridge is counted, broken down both by topic type (configuration, state, command,
+ * attributes) and by component ("sensor", "light", etc). The time spent in IMQTTRemote::publishMessage() is recorded
+ * in a fixed bucket latency histogram. Entities report when an updateX() call was suppressed because the value did
+ * not change.
+ */
+class HaBridgeMetrics {
+public:
+  enum class TopicType {
+    Configuration, // Home Assistant discovery configuration, "homeassistant/<component>/..../config"
+    State,
+    Command,
+    Attributes,
+    Other, // Anything not created by HaBridge::getTopic(), like availability topics.
+  };
+
+  enum class Component {
+    Sensor,
+    BinarySensor,
+    Button,
+    Cover,
+    DeviceAutomation,
+    Event,
+    Fan,
+    Light,
+    Number,
+    Select,
+    Switch,
+    Text,
+    Other,
+  };
+
+  static constexpr size_t NUM_TOPIC_TYPES = static_cast<size_t>(TopicType::Other) + 1;
+  static constexpr size_t NUM_COMPONENTS = static_cast<size_t>(Component::Other) + 1;
+
+  /**
+   * @brief Upper bounds (inclusive) in microseconds for the latency histogram buckets. There is one extra bucket for
+   * latencies above the last bound.
+   */
+  static constexpr std::array<uint32_t, 7> LATENCY_BUCKET_BOUNDS_US = {100, 500, 1000, 5000, 10000, 50000, 100000};
+  static constexpr size_t NUM_LATENCY_BUCKETS = LATENCY_BUCKET_BOUNDS_US.size() + 1;
+
+  /**
+   * @brief A snapshot of counters.
+   */
+  struct Counters {
+    uint32_t messages = 0;     // Number of publish attempts.
+    uint32_t bytes = 0;        // Number of bytes (topic + payload) in publish attempts.
+    uint32_t failures = 0;     // Number of publish attempts where the remote returned false.
+    uint32_t deduplicated = 0; // Number of updateX() calls that did not publish as the value did not change.
+  };
+
+public:
+  /**
+   * @brief Record a publish. Called by HaBridge.
+   *
+   * @param topic_type the topic type, see classify().
+   * @param component the component, see classify().
+   * @param bytes size of the topic and the payload.
+   * @param success the result from IMQTTRemote::publishMessage().
+   * @param latency_us time spent in IMQTTRemote::publishMessage().
+   */
+  void recordPublish(TopicType topic_type, Component component, size_t bytes, bool success, uint32_t latency_us);
+
+  /**
+   * @brief Record that an update was suppressed as the value did not change. Called by the entities.
+   */
+  void recordDeduplicated(Component component);
+
+  /**
+   * @brief Record time spent in HaBridge::publishConfiguration(), building and publishing one discovery message.
+   */
+  void recordDiscovery(uint32_t duration_us);
+
+  /**
+   * @brief Set the number of messages waiting to be published. Set by whoever owns a publish queue, like the MQTT
+   * client outbox.
+   */
+  void setQueueDepth(uint32_t depth) { _queue_depth.store(depth, std::memory_order_relaxed); }
+
+  /**
+   * @brief Record a publish with only a topic alias instead of the topic, see HaBridge::setTopicAliases().
+   *
+   * @param saved_bytes the size of the topic, less the 3 bytes of the alias.
+   */
+  void recordTopicAliasSaved(uint32_t saved_bytes) {
+    _topic_alias_saved_bytes.fetch_add(saved_bytes, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Totals across all topic types and components.
+   */
+  Counters total() const;
+
+  /**
+   * @brief Counters for one topic type. Deduplicated is always 0 here, as it is only tracked per component.
+   */
+  Counters byTopicType(TopicType topic_type) const;
+
+  /**
+   * @brief Counters for one component.
+   */
+  Counters byComponent(Component component) const;
+
+  /**
+   * @brief Number of publishes in the given latency bucket, see LATENCY_BUCKET_BOUNDS_US.
+   */
+  uint32_t latencyBucket(size_t bucket) const;
+
+  /**
+   * @brief The largest latency seen, in microseconds.
+   */
+  uint32_t maxLatencyUs() const { return _max_latency_us.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief The largest message (topic + payload) seen, in bytes.
+   */
+  uint32_t maxMessageBytes() const { return _max_message_bytes.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Total time spent publishing discovery configurations, in microseconds.
+   */
+  uint32_t discoveryDurationUs() const { return _discovery_us.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Number of messages waiting to be published, as last set by setQueueDepth().
+   */
+  uint32_t queueDepth() const { return _queue_depth.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Bytes not sent thanks to topic aliases. The bytes counted elsewhere always include the full topic.
+   */
+  uint32_t topicAliasSavedBytes() const { return _topic_alias_saved_bytes.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Reset all counters to zero. The queue depth is a gauge and is not reset.
+   */
+  void reset();
+
+  /**
+   * @brief Get the topic type and component from a topic created by HaBridge, either a configuration topic
+   * ("homeassistant/<component>/<node_id>/<object_id>/config") or a topic from HaBridge::getTopic()
+   * ("<node_id>/<component>/<object_id>[/<child_object_id>]/<topic type>").
+   */
+  static void classify(std::string_view topic, TopicType &topic_type, Component &component);
+
+  /**
+   * @brief Map a Home Assistant component name, like "binary_sensor", to a Component.
+   */
+  static Component component(std::string_view component);
+
+private:
+  struct AtomicCounters {
+    std::atomic<uint32_t> messages = 0;
+    std::atomic<uint32_t> bytes = 0;
+    std::atomic<uint32_t> failures = 0;
+    std::atomic<uint32_t> deduplicated = 0;
+
+    Counters load() const;
+    void reset();
+  };
+
+  static void updateMax(std::atomic<uint32_t> &max, uint32_t value);
+
+private:
+  std::array<AtomicCounters, NUM_TOPIC_TYPES> _by_topic_type;
+  std::array<AtomicCounters, NUM_COMPONENTS> _by_component;
+  std::array<std::atomic<uint32_t>, NUM_LATENCY_BUCKETS> _latency_buckets = {};
+  std::atomic<uint32_t> _max_latency_us = 0;
+  std::atomic<uint32_t> _max_message_bytes = 0;
+  std::atomic<uint32_t> _discovery_us = 0;
+  std::atomic<uint32_t> _queue_depth = 0;
+  std::atomic<uint32_t> _topic_alias_saved_bytes = 0;
+};
+
+#endif // __HA_BRIDGE_METRICS_H__
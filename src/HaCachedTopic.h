@@ -0,0 +1,69 @@
+#ifndef __HA_CACHED_TOPIC_H__
+#define __HA_CACHED_TOPIC_H__
+
+#include <HaSpinLock.h>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace homeassistantentities {
+
+/**
+ * @brief A topic that is built on first use and then kept, for topics that are published to often with a fixed
+ * payload, like the state topic of a switch. Only a pointer until first used. Topics can not be built when the entity
+ * is constructed, as the HaBridge might not be constructed yet.
+ */
+class CachedTopic {
+public:
+  /**
+   * @brief Get the topic, calling build() to create it the first time.
+   *
+   * @param lock held while checking and building the topic, usually the lock of the entity.
+   * @param build returns the topic, like a call to HaBridge::getTopic().
+   */
+  template <typename Build> const std::string &get(SpinLock &lock, Build build) {
+    std::lock_guard<SpinLock> guard(lock);
+    if (!_topic) {
+      _topic = std::make_unique<std::string>(build());
+    }
+    return *_topic;
+  }
+
+private:
+  std::unique_ptr<std::string> _topic;
+};
+
+/**
+ * @brief Like CachedTopic, for an entity with N state topics, like a light. Each topic is built on first use. Only a
+ * pointer until the first topic is used.
+ */
+template <size_t N> class CachedTopics {
+public:
+  /**
+   * @brief Get the topic at index, calling build() to create it the first time.
+   *
+   * @param lock held while checking and building the topic, usually the lock of the entity.
+   * @param index of the topic, less than N.
+   * @param build returns the topic, like a call to HaBridge::getTopic().
+   */
+  template <typename Build> const std::string &get(SpinLock &lock, size_t index, Build build) {
+    std::lock_guard<SpinLock> guard(lock);
+    if (!_topics) {
+      _topics = std::make_unique<std::array<std::string, N>>();
+    }
+    auto &topic = (*_topics)[index];
+    if (topic.empty()) {
+      topic = build();
+    }
+    return topic;
+  }
+
+private:
+  std::unique_ptr<std::array<std::string, N>> _topics;
+};
+
+} // namespace homeassistantentities
+
+#endif // __HA_CACHED_TOPIC_H__
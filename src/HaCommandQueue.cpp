@@ -0,0 +1,64 @@
+#include "HaCommandQueue.h"
+#include <algorithm>
+#include <mutex>
+
+using namespace homeassistantentities;
+
+HaCommandQueue::HaCommandQueue(size_t capacity) : _capacity(capacity) {}
+
+IMQTTRemote::SubscriptionCallback HaCommandQueue::wrap(IMQTTRemote::SubscriptionCallback callback, bool coalesce) {
+  auto subscription =
+      std::make_shared<const Subscription>(Subscription{.callback = std::move(callback), .coalesce = coalesce});
+  return [this, subscription](std::string topic, std::string message) { push(subscription, topic, message); };
+}
+
+void HaCommandQueue::push(const std::shared_ptr<const Subscription> &subscription, std::string &topic,
+                          std::string &message) {
+  std::lock_guard<SpinLock> lock(_lock);
+  if (subscription->coalesce) {
+    // Removed rather than replaced in place, so that the order across topics is kept, like ON, brightness, OFF.
+    auto pending = std::find_if(_commands.begin(), _commands.end(), [&](const Command &command) {
+      return command.subscription == subscription && command.topic == topic;
+    });
+    if (pending != _commands.end()) {
+      _commands.erase(pending);
+    }
+  }
+
+  if (_commands.size() >= _capacity) {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  _commands.push_back(Command{.subscription = subscription, .topic = std::move(topic), .message = std::move(message)});
+}
+
+size_t HaCommandQueue::dispatch(size_t max_commands) {
+  size_t count = 0;
+  while (count < max_commands) {
+    Command command;
+    {
+      std::lock_guard<SpinLock> lock(_lock);
+      if (_commands.empty()) {
+        break;
+      }
+      command = std::move(_commands.front());
+      _commands.pop_front();
+    }
+    // Run without holding the lock, so new commands can be queued meanwhile.
+    command.subscription->callback(std::move(command.topic), std::move(command.message));
+    count++;
+  }
+  return count;
+}
+
+void HaCommandQueue::discard(std::string_view topic) {
+  std::lock_guard<SpinLock> lock(_lock);
+  _commands.erase(std::remove_if(_commands.begin(), _commands.end(),
+                                 [&](const Command &command) { return command.topic == topic; }),
+                  _commands.end());
+}
+
+size_t HaCommandQueue::size() {
+  std::lock_guard<SpinLock> lock(_lock);
+  return _commands.size();
+}
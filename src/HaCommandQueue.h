@@ -0,0 +1,89 @@
+#ifndef __HA_COMMAND_QUEUE_H__
+#define __HA_COMMAND_QUEUE_H__
+
+#include <HaSpinLock.h>
+#include <IMQTTRemote.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Bounded queue of received commands, so that entity callbacks can run on another task than the MQTT receive
+ * task. Used by HaBridge when enabled with HaBridge::setCommandQueue().
+ *
+ * Subscriptions are wrapped with wrap(). The wrapped callback, called by the MQTT client, only queues the message. The
+ * callbacks run when dispatch() is called. For a coalescing subscription, a command that arrives while there is
+ * already one pending for the same topic replaces the pending one, and is queued last. So if several brightness
+ * commands arrive before dispatch(), only the latest is run, and commands still run in the order of their last message
+ * (a light turned off after a brightness change stays off).
+ *
+ * The queue keeps nothing per subscription: the callback is owned by the wrapped callback, and by the commands pending
+ * for it. So re-subscribing after reconnects or unsubscribing does not grow the queue, as the MQTT client drops the old
+ * wrapped callback.
+ */
+class HaCommandQueue {
+public:
+  /**
+   * @param capacity maximum number of pending commands. Commands arriving when full are dropped.
+   */
+  explicit HaCommandQueue(size_t capacity);
+
+  /**
+   * @brief Get a callback to subscribe with, that queues the message for callback.
+   *
+   * @param callback the callback to run from dispatch().
+   * @param coalesce true to only keep the latest pending message per topic. Set to false if every message matters,
+   * like button presses.
+   */
+  IMQTTRemote::SubscriptionCallback wrap(IMQTTRemote::SubscriptionCallback callback, bool coalesce);
+
+  /**
+   * @brief Run the callbacks for pending commands, oldest first, on the calling task.
+   *
+   * @param max_commands maximum number of commands to run in this call.
+   * @returns number of commands run.
+   */
+  size_t dispatch(size_t max_commands);
+
+  /**
+   * @brief Drop the pending commands for a topic, like after unsubscribing from it. Together with the MQTT client
+   * dropping the wrapped callback, this releases the callback.
+   */
+  void discard(std::string_view topic);
+
+  /**
+   * @brief Number of pending commands.
+   */
+  size_t size();
+
+  /**
+   * @brief Number of commands dropped as the queue was full.
+   */
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+  struct Subscription {
+    IMQTTRemote::SubscriptionCallback callback;
+    bool coalesce;
+  };
+
+  struct Command {
+    std::shared_ptr<const Subscription> subscription;
+    std::string topic;
+    std::string message;
+  };
+
+  void push(const std::shared_ptr<const Subscription> &subscription, std::string &topic, std::string &message);
+
+private:
+  size_t _capacity;
+  homeassistantentities::SpinLock _lock;
+  std::deque<Command> _commands;
+  std::atomic<uint32_t> _dropped = 0;
+};
+
+#endif // __HA_COMMAND_QUEUE_H__
@@ -1,6 +1,10 @@
 #ifndef __HA_ENTITY_H__
 #define __HA_ENTITY_H__
 
+#include <functional>
+#include <string>
+#include <string_view>
+
 /**
  * @brief Abstract for a HaEntity.
  *
@@ -25,6 +29,35 @@ public:
    * @brief Republish any previous published state on any of the available state topics.
    */
   virtual void republishState() = 0;
+
+  /**
+   * @brief Called with a state topic and a function seeding the state cache from a message on that topic.
+   */
+  using StateRestorer =
+      std::function<void(std::string topic, std::function<void(const std::string &message)> restore)>;
+
+  /**
+   * @brief Give the state topics of this entity to add, each with a function that seeds the state cache from a
+   * retained message on that topic, without publishing. Only states not yet set are seeded. This makes the first
+   * updateX() after a reboot only publish if the value differs from what Home Assistant already has. Used by
+   * HaEntityRegistry for a warm start. The default, for entities without state, does nothing.
+   */
+  virtual void restoreState(const StateRestorer &add) {}
+
+  /**
+   * @brief Append the state cache of this entity to record, in the compact binary format of StateRecordWriter (see
+   * HaStateRecord.h). Used by HaEntityRegistry for snapshots. The default, for entities without state, appends
+   * nothing.
+   */
+  virtual void saveState(std::string &record) {}
+
+  /**
+   * @brief Seed the state cache from a record written by saveState(), without publishing. Like restoreState(), only
+   * states not yet set are seeded.
+   *
+   * @returns true if the record could be read, or false if it is not valid for this entity.
+   */
+  virtual bool loadState(std::string_view record) { return false; }
 };
 
 #endif // __HA_ENTITY_H__
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include "HaEntityRegistry.h"
+#include <HaUtilities.h>
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+
+using namespace homeassistantentities;
+
+static constexpr std::string_view PAYLOAD_ONLINE = "online";
+
+HaEntityRegistry::HaEntityRegistry(HaBridge &ha_bridge, Configuration configuration)
+    : _ha_bridge(ha_bridge), _configuration(configuration), _epoch(std::chrono::steady_clock::now()) {}
+
+void HaEntityRegistry::add(HaEntity &entity, uint32_t heartbeat_ms) {
+  _entities.push_back(&entity);
+  _heartbeat_ms.push_back(heartbeat_ms);
+}
+
+bool HaEntityRegistry::begin() {
+  if (_configuration.storage != nullptr) {
+    _battery = std::make_unique<Battery>();
+    loadStorage();
+  }
+  collectStateTopics();
+  beginHeartbeats();
+  if (_battery) {
+    _ha_bridge.setStateFilter(
+        [this](std::string_view topic, std::string_view message) { return filterStoredState(topic, message); });
+  }
+  _ha_bridge.setStateObserver([this](std::string_view topic, std::string_view message, bool success) {
+    onStatePublished(topic, message, success);
+  });
+
+  return _ha_bridge.subscribe(_configuration.birth_topic,
+                              [this](std::string topic, std::string message) { onBirthMessage(message); });
+}
+
+void HaEntityRegistry::onConnected() {
+  bool discovered;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    discovered = _discovered;
+    _discovered = true;
+  }
+
+  // The configurations are retained by the broker, so after the first time only the states need to be republished.
+  // When the states are retained as well (like with a warm start), only those that failed to publish meanwhile.
+  if (discovered) {
+    schedule(_ha_bridge.retainState() ? Pending::UnsentStates : Pending::States, _configuration.reconnect_jitter_ms);
+  } else if (_battery) {
+    // The configurations are only published if changed since before deep sleep. The states are always republished,
+    // the state filter drops those that did not change (only in this pass, see filterStoredState()).
+    auto fingerprint = discoveryFingerprint();
+    bool changed;
+    {
+      std::lock_guard<SpinLock> guard(_lock);
+      changed = fingerprint != _battery->fingerprint;
+      if (changed) {
+        // Home Assistant might not have the states either, like after a factory reset of the node.
+        _battery->fingerprint = fingerprint;
+        _battery->states.clear();
+        _battery->dirty = true;
+      }
+    }
+    schedule(changed ? Pending::All : Pending::States | Pending::FilteredStates, _configuration.reconnect_jitter_ms);
+  } else if (_configuration.warm_start_ms > 0) {
+    // States set before connecting failed to publish, and are newer than the retained ones. The restore does not
+    // overwrite them.
+    beginWarmStart();
+    schedule(Pending::Configurations | Pending::UnsentStates, _configuration.reconnect_jitter_ms);
+  } else {
+    schedule(Pending::All, _configuration.reconnect_jitter_ms);
+  }
+  loop();
+}
+
+void HaEntityRegistry::loop() {
+  endWarmStart();
+  publishPending(true);
+  fireHeartbeats();
+}
+
+bool HaEntityRegistry::flush() {
+  publishPending(false);
+  _ha_bridge.publishQueued();
+  return saveStorage();
+}
+
+void HaEntityRegistry::publishPending(bool paced) {
+  auto now = std::chrono::steady_clock::now();
+  while (true) {
+    uint8_t pending;
+    size_t entity;
+    bool unsent = false;
+    {
+      std::lock_guard<SpinLock> guard(_lock);
+      if (_pending == Pending::None || (paced && now < _publish_at)) {
+        return;
+      }
+      pending = _pending;
+      entity = _next_entity++;
+      _filtered_entity = (pending & Pending::FilteredStates) ? entity : NO_ENTITY;
+      _unfiltered_entity = (pending & Pending::FilteredStates) ? NO_ENTITY : entity;
+      if (entity < _unsent_states.size() && (pending & (Pending::States | Pending::UnsentStates))) {
+        // Set again by onStatePublished() if the republish fails.
+        unsent = _unsent_states[entity] || _untracked_states[entity];
+        _unsent_states[entity] = false;
+      }
+      if (_next_entity >= _entities.size()) {
+        _pending = Pending::None;
+        _next_entity = 0;
+      }
+      _publish_at = now + std::chrono::milliseconds(_configuration.publish_interval_ms);
+    }
+
+    if (entity < _entities.size()) {
+      if (pending & Pending::Configurations) {
+        _entities[entity]->publishConfiguration();
+      }
+      if ((pending & Pending::States) || ((pending & Pending::UnsentStates) && unsent)) {
+        _entities[entity]->republishState();
+      }
+    }
+    {
+      std::lock_guard<SpinLock> guard(_lock);
+      _filtered_entity = NO_ENTITY;
+      _unfiltered_entity = NO_ENTITY;
+    }
+  }
+}
+
+void HaEntityRegistry::publishAll() {
+  for (auto entity : _entities) {
+    entity->publishConfiguration();
+  }
+  for (auto entity : _entities) {
+    entity->republishState();
+  }
+}
+
+uint32_t HaEntityRegistry::jitterMs(uint32_t window_ms) {
+  // Client IDs often only differ in the last characters, like "node-01" and "node-02", which FNV-1a does not spread
+  // to the high bits. Mix them (the MurmurHash3 finalizer) before scaling the hash to the window. Scaling rather than
+  // taking the modulo keeps every node at its relative place in any window.
+  auto hash = fnv1a(_ha_bridge.remote().clientId());
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return static_cast<uint32_t>((static_cast<uint64_t>(hash) * (static_cast<uint64_t>(window_ms) + 1)) >> 32);
+}
+
+void HaEntityRegistry::onBirthMessage(const std::string &message) {
+  if (message == PAYLOAD_ONLINE) {
+    schedule(Pending::All, _configuration.rediscovery_jitter_ms);
+  }
+}
+
+void HaEntityRegistry::schedule(uint8_t pending, uint32_t window_ms) {
+  auto publish_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(jitterMs(window_ms));
+
+  std::lock_guard<SpinLock> guard(_lock);
+  // Start over from the first entity, with both what was pending and the new. A republish that is not filtered, like
+  // after Home Assistant restarted, replaces a filtered one.
+  if ((pending & Pending::States) && !(pending & Pending::FilteredStates)) {
+    _pending = static_cast<uint8_t>(_pending & ~Pending::FilteredStates);
+  }
+  _pending |= pending;
+  _next_entity = 0;
+  _publish_at = publish_at;
+}
+
+void HaEntityRegistry::beginWarmStart() {
+  std::vector<std::string> topics;
+  for (auto entity : _entities) {
+    entity->restoreState([&](std::string topic, std::function<void(const std::string &)> restore) {
+      if (_ha_bridge.subscribe(topic, [restore](std::string, std::string message) { restore(message); })) {
+        topics.push_back(std::move(topic));
+      }
+    });
+  }
+
+  std::lock_guard<SpinLock> guard(_lock);
+  _warm_start_topics = std::move(topics);
+  _warm_start_end = std::chrono::steady_clock::now() + std::chrono::milliseconds(_configuration.warm_start_ms);
+}
+
+void HaEntityRegistry::endWarmStart() {
+  std::vector<std::string> topics;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    if (_warm_start_topics.empty() || std::chrono::steady_clock::now() < _warm_start_end) {
+      return;
+    }
+    topics = std::move(_warm_start_topics);
+    _warm_start_topics.clear();
+  }
+  for (auto &topic : topics) {
+    _ha_bridge.unsubscribe(topic);
+  }
+}
+
+uint32_t HaEntityRegistry::discoveryFingerprint() {
+  _ha_bridge.beginDiscoveryFingerprint();
+  for (auto entity : _entities) {
+    entity->publishConfiguration();
+  }
+  return _ha_bridge.endDiscoveryFingerprint();
+}
+
+bool HaEntityRegistry::filterStoredState(std::string_view topic, std::string_view message) {
+  // Only read after begin(), so no lock needed for the lookup.
+  auto topic_hash = fnv1a(topic);
+  auto it = _state_topics.find(topic_hash);
+  if (it == _state_topics.end()) {
+    return true;
+  }
+
+  std::lock_guard<SpinLock> guard(_lock);
+  for (auto &state : _battery->states) {
+    if (state.topic == topic_hash) {
+      // The republish after waking is always filtered, anything else only the first state on the topic after waking,
+      // when the caches are empty so updateX() can not tell if the value changed. Other republishes by the registry,
+      // like heartbeats, are never filtered.
+      bool first = !state.seen;
+      state.seen = true;
+      if (it->second == _unfiltered_entity || (it->second != _filtered_entity && !first)) {
+        return true;
+      }
+      return state.value != fnv1a(message);
+    }
+  }
+  return true;
+}
+
+void HaEntityRegistry::recordStoredState(uint32_t topic_hash, uint32_t value_hash) {
+  std::lock_guard<SpinLock> guard(_lock);
+  for (auto &state : _battery->states) {
+    if (state.topic == topic_hash) {
+      if (state.value != value_hash) {
+        state.value = value_hash;
+        _battery->dirty = true;
+      }
+      return;
+    }
+  }
+  if (_battery->states.size() < _configuration.max_stored_states) {
+    _battery->states.push_back(StoredState{.topic = topic_hash, .value = value_hash});
+    _battery->dirty = true;
+  }
+}
+
+void HaEntityRegistry::onStatePublished(std::string_view topic, std::string_view message, bool success) {
+  auto topic_hash = fnv1a(topic);
+  if (success && _battery) {
+    // Only once published, so a state that failed to publish before deep sleep is not filtered on the next wake.
+    recordStoredState(topic_hash, fnv1a(message));
+  }
+
+  // Only read after begin(), so no lock needed for the lookup.
+  auto it = _state_topics.find(topic_hash);
+  if (it == _state_topics.end()) {
+    return;
+  }
+  auto entity = it->second;
+  std::lock_guard<SpinLock> guard(_lock);
+  if (!success) {
+    _unsent_states[entity] = true;
+  } else if (_heartbeats && _heartbeat_ms[entity] > 0) {
+    _heartbeats->schedule(entity, _heartbeat_ms[entity]);
+  }
+}
+
+void HaEntityRegistry::collectStateTopics() {
+  _untracked_states.assign(_entities.size(), true);
+  for (size_t i = 0; i < _entities.size(); i++) {
+    _entities[i]->restoreState([&](std::string topic, std::function<void(const std::string &)>) {
+      _state_topics.emplace(fnv1a(topic), static_cast<uint16_t>(i));
+      _untracked_states[i] = false;
+    });
+  }
+
+  std::lock_guard<SpinLock> guard(_lock);
+  _unsent_states.assign(_entities.size(), false);
+}
+
+void HaEntityRegistry::beginHeartbeats() {
+  // Any state published by the entity restarts its heartbeat, see onStatePublished().
+  if (std::none_of(_heartbeat_ms.begin(), _heartbeat_ms.end(), [](uint32_t ms) { return ms > 0; })) {
+    return;
+  }
+
+  auto heartbeats = std::make_unique<TimerWheel>(_entities.size(), ticks());
+  for (size_t i = 0; i < _entities.size(); i++) {
+    if (_heartbeat_ms[i] > 0) {
+      heartbeats->schedule(i, _heartbeat_ms[i]);
+    }
+  }
+  std::lock_guard<SpinLock> guard(_lock);
+  _heartbeats = std::move(heartbeats);
+}
+
+void HaEntityRegistry::fireHeartbeats() {
+  if (!_heartbeats) {
+    return;
+  }
+
+  std::vector<size_t> due;
+  bool connected;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    _heartbeats->advance(ticks(), [&](size_t entity) { due.push_back(entity); });
+    // Restarted here as well, as republishState() publishes nothing for an entity without state yet.
+    for (auto entity : due) {
+      _heartbeats->schedule(entity, _heartbeat_ms[entity]);
+    }
+    connected = _discovered;
+  }
+
+  if (connected) {
+    for (auto entity : due) {
+      {
+        std::lock_guard<SpinLock> guard(_lock);
+        _unfiltered_entity = entity;
+      }
+      _entities[entity]->republishState();
+    }
+    std::lock_guard<SpinLock> guard(_lock);
+    _unfiltered_entity = NO_ENTITY;
+  }
+}
+
+uint32_t HaEntityRegistry::ticks() const {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _epoch).count());
+}
+
+// Stored as 32 bit words: magic, fingerprint, number of states, then topic and value hash for each state.
+
+void HaEntityRegistry::loadStorage() {
+  std::vector<uint32_t> words(3 + 2 * _configuration.max_stored_states);
+  auto size = _configuration.storage->load(words.data(), words.size() * sizeof(uint32_t));
+  if (size < 3 * sizeof(uint32_t) || words[0] != STORAGE_MAGIC || words[2] > _configuration.max_stored_states ||
+      size != (3 + 2 * words[2]) * sizeof(uint32_t)) {
+    // Nothing stored yet, or from another version. Everything will be published.
+    return;
+  }
+
+  _battery->fingerprint = words[1];
+  _battery->states.reserve(words[2]);
+  for (size_t i = 0; i < words[2]; i++) {
+    _battery->states.push_back(StoredState{.topic = words[3 + 2 * i], .value = words[4 + 2 * i]});
+  }
+}
+
+bool HaEntityRegistry::saveStorage() {
+  if (!_battery) {
+    return true;
+  }
+
+  std::vector<uint32_t> words;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    if (!_battery->dirty) {
+      return true;
+    }
+    _battery->dirty = false;
+    words.reserve(3 + 2 * _battery->states.size());
+    words.push_back(STORAGE_MAGIC);
+    words.push_back(_battery->fingerprint);
+    words.push_back(static_cast<uint32_t>(_battery->states.size()));
+    for (auto &state : _battery->states) {
+      words.push_back(state.topic);
+      words.push_back(state.value);
+    }
+  }
+
+  if (!_configuration.storage->save(words.data(), words.size() * sizeof(uint32_t))) {
+    std::lock_guard<SpinLock> guard(_lock);
+    _battery->dirty = true;
+    return false;
+  }
+  return true;
+}
+
+void HaEntityRegistry::snapshotKeys() {
+  if (_snapshot.size() == _entities.size()) {
+    return;
+  }
+
+  _snapshot.clear();
+  _snapshot.reserve(_entities.size());
+  for (auto entity : _entities) {
+    // The state topics identify an entity across firmware versions, unlike its position in _entities.
+    std::string topics;
+    entity->restoreState([&](std::string topic, std::function<void(const std::string &)>) {
+      topics += topic;
+      topics += '\n';
+    });
+    _snapshot.push_back(SnapshotEntry{.key = topics.empty() ? 0 : fnv1a(topics), .hash = 0});
+  }
+}
+
+bool HaEntityRegistry::restoreSnapshot(IHaStorage &storage) {
+  snapshotKeys();
+
+  bool restored = false;
+  std::string record;
+  for (size_t i = 0; i < _entities.size(); i++) {
+    auto &entry = _snapshot[i];
+    if (entry.key == 0) {
+      continue;
+    }
+
+    record.resize(64);
+    auto size = storage.loadRecord(entry.key, record.data(), record.size());
+    if (size > record.size()) {
+      record.resize(size);
+      size = storage.loadRecord(entry.key, record.data(), record.size());
+    }
+    if (size == 0 || size > record.size()) {
+      continue;
+    }
+    record.resize(size);
+
+    if (static_cast<uint8_t>(record[0]) == SNAPSHOT_VERSION &&
+        _entities[i]->loadState(std::string_view(record).substr(1))) {
+      // Saved as is until the state changes.
+      entry.hash = fnv1a(record);
+      restored = true;
+    }
+  }
+  return restored;
+}
+
+bool HaEntityRegistry::saveSnapshot(IHaStorage &storage) {
+  snapshotKeys();
+
+  bool saved = true;
+  std::string record;
+  for (size_t i = 0; i < _entities.size(); i++) {
+    auto &entry = _snapshot[i];
+    if (entry.key == 0) {
+      continue;
+    }
+
+    record.assign(1, static_cast<char>(SNAPSHOT_VERSION));
+    _entities[i]->saveState(record);
+    auto hash = fnv1a(record);
+    if (hash == entry.hash) {
+      continue;
+    }
+    if (storage.saveRecord(entry.key, record.data(), record.size())) {
+      entry.hash = hash;
+    } else {
+      saved = false;
+    }
+  }
+  return saved;
+}
@@ -0,0 +1,276 @@
+#ifndef __HA_ENTITY_REGISTRY_H__
+#define __HA_ENTITY_REGISTRY_H__
+
+#include <HaBridge.h>
+#include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaTimerWheel.h>
+#include <IHaStorage.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Keeps track of the entities of a node, and publishes their configurations and states when needed instead of
+ * on every MQTT reconnect:
+ * - On the first connection, the configurations and states of all entities are published.
+ * - On later reconnects (like after a Wi-Fi drop), the configurations are still retained by the broker, so only the
+ * states are republished. If the states are retained too (see HaBridge::setRetainState()), only the states of entities
+ * that failed to publish a state meanwhile are republished.
+ * - When Home Assistant restarts, it publishes "online" on its birth topic ("homeassistant/status"). The
+ * configurations and states are then republished.
+ *
+ * When a broker or Home Assistant restarts, all nodes get the event at the same time. To not have them all publish at
+ * once, each node waits a delay within a window before publishing, and can be set to publish one entity at a time.
+ * The delay is derived from the MQTT client ID, so it is the same every time for a node, and spread over the window
+ * for a fleet of nodes.
+ *
+ * With warm_start_ms, the states retained by the broker are used to seed the state caches of the entities after a
+ * reboot (see HaEntity::restoreState()), so the first updateX() of each entity only publishes if the value changed.
+ * The states must be published retained for this, see HaBridge::setRetainState(). On the first connection, only the
+ * configurations are then published, plus the states set before connecting (they failed to publish, and are newer than
+ * the retained ones). The state topics are subscribed to for warm_start_ms.
+ *
+ * Battery powered nodes waking from deep sleep can set a storage, which keeps a fingerprint of the configurations
+ * and a hash of the last value published on each state topic during deep sleep. On each wake, the configurations are
+ * only published if the fingerprint changed, and the republish of the states after connecting skips those that did
+ * not change. The state caches are empty after waking, so the first updateX() (or publishX()) on each state topic is
+ * compared with the stored hash as well, and skipped if the value did not change. This works both when the sensors are
+ * read before and after onConnected(). Later publishes on the topic, heartbeats and the republish after Home
+ * Assistant restarted are always published.
+ * Call flush() when done to publish everything in one burst and save the storage, then go to deep sleep.
+ *
+ * Entities can be added with a heartbeat, the longest time their state may go unpublished. Needed for sensors with
+ * expire_after, where Home Assistant marks the sensor unavailable when no state arrived for a while, even if the value
+ * did not change. Each publish of a state of the entity restarts its heartbeat, and when it runs out, loop()
+ * republishes the state. The heartbeats are kept in a timer wheel, so loop() only visits the entities that are due.
+ *
+ * To resume with warm state caches after a restart without a broker round trip, save a snapshot of the caches with
+ * saveSnapshot() (like when states changed, or before a planned restart), and restore it with restoreSnapshot() at
+ * boot.
+ *
+ * Usage: add() all entities, call begin() once, onConnected() from the MQTT connect callback and loop() regularly.
+ */
+class HaEntityRegistry {
+public:
+  struct Configuration {
+    /**
+     * @brief The topic Home Assistant publishes "online" on when it has started. This is configured in the MQTT
+     * integration in Home Assistant, and defaults to "homeassistant/status".
+     */
+    std::string birth_topic = "homeassistant/status";
+
+    /**
+     * @brief Maximum delay before republishing after Home Assistant has restarted, in milliseconds.
+     */
+    uint32_t rediscovery_jitter_ms = 5000;
+
+    /**
+     * @brief Maximum delay before publishing after connecting to the broker, in milliseconds. 0 to publish directly
+     * from onConnected().
+     */
+    uint32_t reconnect_jitter_ms = 0;
+
+    /**
+     * @brief Time between publishing each entity, in milliseconds. 0 to publish all entities at once.
+     */
+    uint32_t publish_interval_ms = 0;
+
+    /**
+     * @brief How long to listen for retained states after the first connection, in milliseconds. 0 for no warm start.
+     * Values published before the retained states have arrived are published as usual.
+     */
+    uint32_t warm_start_ms = 0;
+
+    /**
+     * @brief Storage kept during deep sleep, like RTC memory (see HaBufferStorage), for battery mode. nullptr for no
+     * battery mode. Must outlive the registry.
+     */
+    IHaStorage *storage = nullptr;
+
+    /**
+     * @brief In battery mode, the maximum number of state topics to keep the last value for. Uses 8 bytes of storage
+     * each, plus 12 bytes in total. States on other topics are always published.
+     */
+    uint16_t max_stored_states = 32;
+  };
+
+  inline static Configuration _default = {.birth_topic = "homeassistant/status",
+                                          .rediscovery_jitter_ms = 5000,
+                                          .reconnect_jitter_ms = 0,
+                                          .publish_interval_ms = 0,
+                                          .warm_start_ms = 0,
+                                          .storage = nullptr,
+                                          .max_stored_states = 32};
+
+  /**
+   * @brief Construct a new Ha Entity Registry object
+   *
+   * @param ha_bridge the bridge to subscribe to the birth topic with.
+   * @param configuration the configuration for this registry.
+   */
+  HaEntityRegistry(HaBridge &ha_bridge, Configuration configuration = _default);
+
+public:
+  /**
+   * @brief Add an entity. Add all entities before begin(). The entity must outlive the registry.
+   *
+   * @param heartbeat_ms republish the state of the entity from loop() when none was published for this long, in
+   * milliseconds. For a sensor with expire_after, use less than expire_after, like half. 0 for no heartbeat (default).
+   * The heartbeat might run out up to one loop() interval early.
+   */
+  void add(HaEntity &entity, uint32_t heartbeat_ms = 0);
+
+  /**
+   * @brief Subscribe to the birth topic of Home Assistant, start the heartbeats, and in battery mode load the storage.
+   * Call once, after the entities have been added.
+   *
+   * @returns the result from HaBridge::subscribe().
+   */
+  bool begin();
+
+  /**
+   * @brief Call when connected to the MQTT broker, including on reconnects. The first time, the configurations and
+   * states of all entities are published (only the configurations and the states that failed to publish with a warm
+   * start, and only what changed in battery mode). After that, only the states, or only those that failed to publish
+   * if the states are retained. Publishes from loop() if there is a delay (reconnect_jitter_ms) or a
+   * publish_interval_ms, else directly.
+   */
+  void onConnected();
+
+  /**
+   * @brief Call regularly, e.g. from the Arduino loop() or a task. Publishes the entities when the delay has passed,
+   * paced by publish_interval_ms, ends the warm start, and republishes the states of entities with a heartbeat that
+   * ran out (once connected).
+   */
+  void loop();
+
+  /**
+   * @brief The delay for this node within a window, derived from the MQTT client ID.
+   *
+   * @param window_ms the window, like rediscovery_jitter_ms.
+   * @returns the delay, from 0 to window_ms.
+   */
+  uint32_t jitterMs(uint32_t window_ms);
+
+  /**
+   * @brief Publish the configurations and states of all entities now.
+   */
+  void publishAll();
+
+  /**
+   * @brief Publish everything pending now, ignoring delays and pacing, then everything in the publish queue of the
+   * bridge (see HaBridge::setPublishQueue()), and in battery mode save the storage. Call before going to deep sleep.
+   * The messages have then been handed to the MQTT client, which may need to be given time to send them.
+   *
+   * @returns true if the storage was saved, or not in battery mode.
+   */
+  bool flush();
+
+  /**
+   * @brief Seed the state caches of the entities from a snapshot saved with saveSnapshot(), without publishing. Call
+   * after the entities have been added, and before states are published. Like for a warm start, only states not yet
+   * set are seeded, and records from another firmware that no longer match an entity are ignored.
+   *
+   * @param storage with records, like HaNvsStorage or HaFileStorage.
+   * @returns true if the state of at least one entity was restored.
+   */
+  bool restoreSnapshot(IHaStorage &storage);
+
+  /**
+   * @brief Save the state caches of the entities to storage, one record per entity (see HaEntity::saveState()). Only
+   * the records of entities with a state that changed since the last save or restore are written, so this is cheap to
+   * call often. Entities are identified by their state topics, entities without state are skipped.
+   *
+   * @param storage with records, like HaNvsStorage or HaFileStorage. Use the same storage for every save.
+   * @returns true if all changed records were written.
+   */
+  bool saveSnapshot(IHaStorage &storage);
+
+private:
+  // Flags, what to publish for each entity. UnsentStates only republishes the states of entities with a state that
+  // failed to publish, see onStatePublished(), and of entities with unknown state topics. FilteredStates makes States
+  // the republish after waking in battery mode, where states published before deep sleep are dropped, see
+  // filterStoredState().
+  enum Pending : uint8_t {
+    None = 0,
+    States = 1,
+    Configurations = 2,
+    All = States | Configurations,
+    UnsentStates = 4,
+    FilteredStates = 8
+  };
+
+  void onBirthMessage(const std::string &message);
+  void schedule(uint8_t pending, uint32_t window_ms);
+  void beginWarmStart();
+  void endWarmStart();
+  void publishPending(bool paced);
+  void loadStorage();
+  bool saveStorage();
+  bool filterStoredState(std::string_view topic, std::string_view message);
+  void recordStoredState(uint32_t topic_hash, uint32_t value_hash);
+  void onStatePublished(std::string_view topic, std::string_view message, bool success);
+  void collectStateTopics();
+  void beginHeartbeats();
+  void fireHeartbeats();
+  uint32_t ticks() const;
+  uint32_t discoveryFingerprint();
+  void snapshotKeys();
+
+private:
+  static constexpr uint32_t STORAGE_MAGIC = 0x48414531; // "HAE1"
+  static constexpr size_t NO_ENTITY = SIZE_MAX;
+
+  struct StoredState {
+    uint32_t topic; // FNV-1a hash of the state topic.
+    uint32_t value; // FNV-1a hash of the last message published on it.
+    bool seen = false; // A state was published or filtered on it since waking. Not stored.
+  };
+
+  // First byte of each snapshot record. Increase when the record of any entity changes format.
+  static constexpr uint8_t SNAPSHOT_VERSION = 1;
+
+  struct SnapshotEntry {
+    uint32_t key;  // FNV-1a hash of the state topics of the entity, or 0 if it has no state.
+    uint32_t hash; // FNV-1a hash of the record last saved or restored, or 0 if none.
+  };
+
+  struct Battery {
+    uint32_t fingerprint = 0; // Of the configurations, see HaBridge::beginDiscoveryFingerprint().
+    std::vector<StoredState> states;
+    bool dirty = false; // Changed since loaded or saved.
+  };
+
+private:
+  HaBridge &_ha_bridge;
+  Configuration _configuration;
+  std::vector<HaEntity *> _entities;
+  std::vector<SnapshotEntry> _snapshot; // One for each entity, once a snapshot was restored or saved.
+  std::vector<uint32_t> _heartbeat_ms;   // One for each entity, 0 for no heartbeat.
+  std::unordered_map<uint32_t, uint16_t> _state_topics; // FNV-1a hash of a state topic to the entity index.
+  // One for each entity, true if it gave no state topics in restoreState(). Failed publishes of these can not be told
+  // apart, so they are always republished with UnsentStates.
+  std::vector<bool> _untracked_states;
+  std::chrono::steady_clock::time_point _epoch;             // For ticks().
+
+private:
+  homeassistantentities::SpinLock _lock; // For the state below, which is set from the MQTT task.
+  bool _discovered = false;
+  uint8_t _pending = Pending::None;
+  std::vector<bool> _unsent_states; // One for each entity, true if a state failed to publish since last republished.
+  size_t _next_entity = 0;
+  size_t _filtered_entity = NO_ENTITY; // The entity republished after waking in battery mode, see filterStoredState().
+  size_t _unfiltered_entity = NO_ENTITY; // The entity republished by a heartbeat or reconnect, never filtered.
+  std::chrono::steady_clock::time_point _publish_at;
+  std::vector<std::string> _warm_start_topics; // Subscribed to until _warm_start_end.
+  std::chrono::steady_clock::time_point _warm_start_end;
+  std::unique_ptr<Battery> _battery; // Only in battery mode.
+  std::unique_ptr<homeassistantentities::TimerWheel> _heartbeats; // Only if any entity has a heartbeat.
+};
+
+#endif // __HA_ENTITY_REGISTRY_H__
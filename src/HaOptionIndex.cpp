@@ -0,0 +1,59 @@
+#include "HaOptionIndex.h"
+#include <cstring>
+
+namespace homeassistantentities {
+
+OptionIndex::OptionIndex(const std::set<std::string> &options) {
+  if (options.empty()) {
+    return;
+  }
+
+  size_t characters = 0;
+  for (const auto &option : options) {
+    characters += option.size();
+  }
+
+  auto count = options.size();
+  auto words = 2 + count + (characters + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+  _data = std::make_unique<uint32_t[]>(words);
+  _data[0] = static_cast<uint32_t>(count);
+
+  // std::set iterates in sorted order, so the options are already sorted.
+  auto chars = reinterpret_cast<char *>(&_data[2 + count]);
+  uint32_t offset = 0;
+  size_t i = 0;
+  for (const auto &option : options) {
+    _data[1 + i++] = offset;
+    std::memcpy(chars + offset, option.data(), option.size());
+    offset += static_cast<uint32_t>(option.size());
+  }
+  _data[1 + count] = offset;
+}
+
+std::optional<size_t> OptionIndex::find(std::string_view option) const {
+  size_t low = 0;
+  size_t high = size();
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    auto compare = at(middle).compare(option);
+    if (compare == 0) {
+      return middle;
+    } else if (compare < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return std::nullopt;
+}
+
+std::string_view OptionIndex::at(size_t index) const {
+  if (index >= size()) {
+    return std::string_view();
+  }
+  auto count = _data[0];
+  auto chars = reinterpret_cast<const char *>(&_data[2 + count]);
+  return std::string_view(chars + _data[1 + index], _data[2 + index] - _data[1 + index]);
+}
+
+} // namespace homeassistantentities
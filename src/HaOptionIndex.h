@@ -0,0 +1,52 @@
+#ifndef __HA_OPTION_INDEX_H__
+#define __HA_OPTION_INDEX_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace homeassistantentities {
+
+/**
+ * @brief A fixed, sorted list of options, like the options of a select or the presets of a fan, in one allocation.
+ * Looking up an option is a binary search, and an option can be referred to by its index (its position in sorted
+ * order, same as when iterating the std::set it was built from).
+ *
+ * Compared to keeping the std::set, this is one allocation rather than one per option, and entities can keep the
+ * current option as an index rather than as a copy of the string.
+ */
+class OptionIndex {
+public:
+  OptionIndex() = default;
+  explicit OptionIndex(const std::set<std::string> &options);
+
+  /**
+   * @brief Number of options.
+   */
+  size_t size() const { return _data ? _data[0] : 0; }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Get the index of an option, or std::nullopt if not one of the options.
+   */
+  std::optional<size_t> find(std::string_view option) const;
+
+  /**
+   * @brief Get the option at index, or an empty string if out of range. The view is valid for the lifetime of this
+   * OptionIndex.
+   */
+  std::string_view at(size_t index) const;
+
+private:
+  // Number of options, then size() + 1 offsets into the characters, then the characters of all options.
+  std::unique_ptr<uint32_t[]> _data;
+};
+
+} // namespace homeassistantentities
+
+#endif // __HA_OPTION_INDEX_H__
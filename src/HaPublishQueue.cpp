@@ -0,0 +1,78 @@
+#include "HaPublishQueue.h"
+#include <cstdint>
+
+static size_t roundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+HaPublishQueue::HaPublishQueue(size_t capacity, std::pmr::memory_resource *resource)
+    : _resource(resource != nullptr ? resource : std::pmr::get_default_resource()) {
+#else
+HaPublishQueue::HaPublishQueue(size_t capacity) {
+#endif
+  size_t size = roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+  _slots = std::make_unique<Slot[]>(size);
+  _mask = size - 1;
+  for (size_t i = 0; i < size; i++) {
+    _slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool HaPublishQueue::push(std::string_view topic, std::string_view message, bool retain) {
+  Slot *slot;
+  size_t position = _enqueue_position.load(std::memory_order_relaxed);
+  while (true) {
+    slot = &_slots[position & _mask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (diff == 0) {
+      // Slot is free for this position, try to claim it.
+      if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Slot still holds a message from the previous lap, the queue is full.
+      return false;
+    } else {
+      // Another producer claimed this position.
+      position = _enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+  slot->message.emplace(Message{String(topic, _resource), String(message, _resource), retain});
+#else
+  slot->message.emplace(Message{String(topic), String(message), retain});
+#endif
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+std::optional<HaPublishQueue::Message> HaPublishQueue::pop() {
+  size_t position = _dequeue_position.load(std::memory_order_relaxed);
+  Slot &slot = _slots[position & _mask];
+  size_t sequence = slot.sequence.load(std::memory_order_acquire);
+  if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0) {
+    // Empty, or the producer of this position has not finished yet.
+    return std::nullopt;
+  }
+
+  // Moved, so the strings keep their allocator.
+  std::optional<Message> message(std::move(slot.message));
+  slot.message.reset();
+  // Free the slot for the producer one lap ahead.
+  slot.sequence.store(position + _mask + 1, std::memory_order_release);
+  _dequeue_position.store(position + 1, std::memory_order_relaxed);
+  return message;
+}
+
+size_t HaPublishQueue::size() const {
+  size_t enqueued = _enqueue_position.load(std::memory_order_relaxed);
+  size_t dequeued = _dequeue_position.load(std::memory_order_relaxed);
+  return enqueued > dequeued ? enqueued - dequeued : 0;
+}
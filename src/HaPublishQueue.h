@@ -0,0 +1,89 @@
+#ifndef __HA_PUBLISH_QUEUE_H__
+#define __HA_PUBLISH_QUEUE_H__
+
+#include <HaUtilities.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Bounded lock-free queue of messages to publish, with any number of producers and a single consumer. Used by
+ * HaBridge in queued mode (see HaBridge::setPublishQueue()), where entities can be updated from any task and the
+ * messages are published from the task owning the MQTT client.
+ *
+ * Each slot has a sequence number telling if it is free for the producer with that position, or filled for the
+ * consumer. Producers claim a position with a compare and swap, fill the slot and then publish it by bumping the
+ * sequence number.
+ *
+ * Where std::pmr is available, the strings of the queued messages are allocated from a memory resource, like one
+ * using PSRAM, see HaBridge::setMemoryResource().
+ */
+class HaPublishQueue {
+public:
+#ifdef HA_HAS_MEMORY_RESOURCE
+  using String = std::pmr::string;
+#else
+  using String = std::string;
+#endif
+
+  struct Message {
+    String topic;
+    String message;
+    bool retain = false;
+  };
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+  /**
+   * @param capacity maximum number of messages in the queue. Rounded up to a power of two.
+   * @param resource where the strings of the messages are allocated from, or nullptr for the default resource. Must
+   * outlive the queue.
+   */
+  explicit HaPublishQueue(size_t capacity, std::pmr::memory_resource *resource = nullptr);
+#else
+  /**
+   * @param capacity maximum number of messages in the queue. Rounded up to a power of two.
+   */
+  explicit HaPublishQueue(size_t capacity);
+#endif
+
+  /**
+   * @brief Add a copy of a message to the queue. Can be called from any task.
+   *
+   * @returns true on success, false if the queue is full.
+   */
+  bool push(std::string_view topic, std::string_view message, bool retain);
+
+  /**
+   * @brief Take the oldest message from the queue. Must only be called from one task at a time. The message keeps the
+   * memory resource of the queue.
+   *
+   * @returns the message, or std::nullopt if the queue is empty.
+   */
+  std::optional<Message> pop();
+
+  /**
+   * @brief Number of messages in the queue. Approximate if there are concurrent push() or pop().
+   */
+  size_t size() const;
+
+  size_t capacity() const { return _mask + 1; }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    std::optional<Message> message; // Emplaced rather than assigned, to allocate from the resource of the queue.
+  };
+
+  std::unique_ptr<Slot[]> _slots;
+#ifdef HA_HAS_MEMORY_RESOURCE
+  std::pmr::memory_resource *_resource;
+#endif
+  size_t _mask;
+  std::atomic<size_t> _enqueue_position = 0;
+  std::atomic<size_t> _dequeue_position = 0;
+};
+
+#endif // __HA_PUBLISH_QUEUE_H__
@@ -0,0 +1,77 @@
+#ifndef __HA_SPIN_LOCK_H__
+#define __HA_SPIN_LOCK_H__
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#if __has_include(<freertos/FreeRTOS.h>)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace homeassistantentities {
+
+/**
+ * @brief A one byte lock for the state caches in the entities, which are only held while copying a value. Can be used
+ * with std::lock_guard.
+ *
+ * On FreeRTOS, a task that does not get the lock sleeps for a tick before trying again, so that a lower priority task
+ * holding the lock on the same core can finish.
+ */
+class SpinLock {
+public:
+  void lock() {
+    while (_flag.test_and_set(std::memory_order_acquire)) {
+#if __has_include(<freertos/FreeRTOS.h>)
+      vTaskDelay(1);
+#endif
+    }
+  }
+
+  void unlock() { _flag.clear(std::memory_order_release); }
+
+private:
+  std::atomic_flag _flag = ATOMIC_FLAG_INIT;
+};
+
+/**
+ * @brief Get a copy of value, holding lock while copying.
+ */
+template <typename T> T loadLocked(SpinLock &lock, const T &value) {
+  std::lock_guard<SpinLock> guard(lock);
+  return value;
+}
+
+/**
+ * @brief Compare target to value, holding lock while comparing. Unlike comparing the result of loadLocked(), this does
+ * not copy target. An empty std::optional target is never equal to value.
+ */
+template <typename T, typename V> bool equalsLocked(SpinLock &lock, const T &target, const V &value) {
+  std::lock_guard<SpinLock> guard(lock);
+  return target == value;
+}
+
+/**
+ * @brief Assign value to target, holding lock while assigning.
+ */
+template <typename T, typename V> void storeLocked(SpinLock &lock, T &target, V &&value) {
+  std::lock_guard<SpinLock> guard(lock);
+  target = std::forward<V>(value);
+}
+
+/**
+ * @brief Assign value to target if target is empty, holding lock while assigning. For seeding a cache without
+ * overwriting a value set since.
+ */
+template <typename T, typename V> void storeIfEmptyLocked(SpinLock &lock, std::optional<T> &target, V &&value) {
+  std::lock_guard<SpinLock> guard(lock);
+  if (!target) {
+    target = std::forward<V>(value);
+  }
+}
+
+} // namespace homeassistantentities
+
+#endif // __HA_SPIN_LOCK_H__
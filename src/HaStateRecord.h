@@ -0,0 +1,117 @@
+#ifndef __HA_STATE_RECORD_H__
+#define __HA_STATE_RECORD_H__
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace homeassistantentities {
+
+/**
+ * @brief Writes the cached state of an entity as a compact binary record, see HaEntity::saveState(). Numbers are
+ * written little endian, strings with a two byte length, and optionals with a byte telling if they have a value.
+ */
+class StateRecordWriter {
+public:
+  explicit StateRecordWriter(std::string &record) : _record(record) {}
+
+  void put(bool value) { put(static_cast<uint8_t>(value ? 1 : 0)); }
+  void put(uint8_t value) { _record += static_cast<char>(value); }
+  void put(uint16_t value) { putBytes(value, sizeof(value)); }
+  void put(uint32_t value) { putBytes(value, sizeof(value)); }
+  void put(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(bits);
+  }
+  void put(std::string_view value) {
+    auto size = value.size() < UINT16_MAX ? value.size() : UINT16_MAX;
+    put(static_cast<uint16_t>(size));
+    _record.append(value.data(), size);
+  }
+  template <typename T> void put(const std::optional<T> &value) {
+    put(value.has_value());
+    if (value) {
+      put(*value);
+    }
+  }
+
+private:
+  void putBytes(uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+      _record += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+  }
+
+private:
+  std::string &_record;
+};
+
+/**
+ * @brief Reads a record written with StateRecordWriter, with a get() for each put(). Reading past the end of the
+ * record gives zeros, empty strings and empty optionals, and makes ok() false.
+ */
+class StateRecordReader {
+public:
+  explicit StateRecordReader(std::string_view record) : _record(record) {}
+
+  /**
+   * @brief true if everything read so far was in the record.
+   */
+  bool ok() const { return _ok; }
+
+  void get(bool &value) { value = getBytes(1) != 0; }
+  void get(uint8_t &value) { value = static_cast<uint8_t>(getBytes(1)); }
+  void get(uint16_t &value) { value = static_cast<uint16_t>(getBytes(2)); }
+  void get(uint32_t &value) { value = getBytes(4); }
+  void get(float &value) {
+    uint32_t bits = getBytes(4);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+  void get(std::string &value) {
+    size_t size = getBytes(2);
+    if (size > _record.size()) {
+      _ok = false;
+      _record = std::string_view();
+      size = 0;
+    }
+    value.assign(_record.data(), size);
+    _record.remove_prefix(size);
+  }
+  template <typename T> void get(std::optional<T> &value) {
+    bool has_value;
+    get(has_value);
+    if (has_value && _ok) {
+      T v{};
+      get(v);
+      value = std::move(v);
+    } else {
+      value.reset();
+    }
+  }
+
+private:
+  uint32_t getBytes(size_t bytes) {
+    if (bytes > _record.size()) {
+      _ok = false;
+      _record = std::string_view();
+      return 0;
+    }
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(_record[i])) << (8 * i);
+    }
+    _record.remove_prefix(bytes);
+    return value;
+  }
+
+private:
+  std::string_view _record;
+  bool _ok = true;
+};
+
+} // namespace homeassistantentities
+
+#endif // __HA_STATE_RECORD_H__
@@ -0,0 +1,92 @@
+#include "HaStringPool.h"
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace homeassistantentities {
+
+StringPool::Handle StringPool::intern(std::string_view str) {
+  if (str.empty()) {
+    return EMPTY;
+  }
+  // At most half full, so probe sequences stay short.
+  if (_entries.size() * 2 >= _index.size()) {
+    growIndex();
+  }
+  auto mask = _index.size() - 1;
+  auto slot = fnv1a(str) & mask;
+  for (; _index[slot] != EMPTY; slot = (slot + 1) & mask) {
+    if (_entries[_index[slot]] == str) {
+      return _index[slot];
+    }
+  }
+  if (_entries.size() > std::numeric_limits<Handle>::max()) {
+    std::abort();
+  }
+
+  char *data;
+  if (str.size() > CHUNK_SIZE / 4) {
+    // Long strings get their own allocation, so they don't waste the rest of a chunk.
+    data = allocate(str.size());
+  } else {
+    if (str.size() > _chunk_left) {
+      _chunk = allocate(CHUNK_SIZE);
+      _chunk_left = CHUNK_SIZE;
+    }
+    data = _chunk;
+    _chunk += str.size();
+    _chunk_left -= str.size();
+  }
+  std::memcpy(data, str.data(), str.size());
+
+  auto handle = static_cast<Handle>(_entries.size());
+  _entries.emplace_back(data, str.size());
+  _index[slot] = handle;
+  return handle;
+}
+
+void StringPool::growIndex() {
+  std::vector<Handle> index(_index.empty() ? 64 : _index.size() * 2, EMPTY);
+  auto mask = index.size() - 1;
+  for (size_t handle = 1; handle < _entries.size(); handle++) {
+    auto slot = fnv1a(_entries[handle]) & mask;
+    while (index[slot] != EMPTY) {
+      slot = (slot + 1) & mask;
+    }
+    index[slot] = static_cast<Handle>(handle);
+  }
+  _index = std::move(index);
+}
+
+StringPool::~StringPool() {
+  for (auto &chunk : _chunks) {
+#ifdef HA_HAS_MEMORY_RESOURCE
+    if (chunk.resource != nullptr) {
+      chunk.resource->deallocate(chunk.data, chunk.size, 1);
+      continue;
+    }
+#endif
+    delete[] chunk.data;
+  }
+}
+
+char *StringPool::allocate(size_t size) {
+  Chunk chunk;
+  chunk.size = size;
+#ifdef HA_HAS_MEMORY_RESOURCE
+  chunk.resource = _resource;
+  chunk.data = _resource != nullptr ? static_cast<char *>(_resource->allocate(size, 1)) : new char[size];
+#else
+  chunk.data = new char[size];
+#endif
+  _chunks.push_back(chunk);
+  _bytes += size;
+  return chunk.data;
+}
+
+StringPool &stringPool() {
+  static StringPool pool;
+  return pool;
+}
+
+} // namespace homeassistantentities
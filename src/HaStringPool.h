@@ -0,0 +1,121 @@
+#ifndef __HA_STRING_POOL_H__
+#define __HA_STRING_POOL_H__
+
+#include <HaUtilities.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace homeassistantentities {
+
+/**
+ * @brief Interning pool for the strings entities keep around, like names, object IDs and child object IDs. Each
+ * distinct string is stored once, in chunks that are never moved or freed, and entities keep a 16 bit handle to it
+ * (see InternedString). Strings like "measurement" or a child object ID used by several entities are thus only stored
+ * once.
+ *
+ * Strings are found through a hash index over the entries, so interning the strings of N entities is O(N) rather
+ * than comparing each new string with all strings in the pool.
+ *
+ * Interning is not thread safe, and is meant to be done while constructing the entities, before any task is
+ * publishing. Fixed strings, like components ("sensor", "light") and topic types ("state", "command"), are string
+ * literals in the entities and in HaBridge and are not interned.
+ */
+class StringPool {
+public:
+  using Handle = uint16_t;
+
+  StringPool() = default;
+  StringPool(const StringPool &) = delete;
+  StringPool &operator=(const StringPool &) = delete;
+  ~StringPool();
+
+  /**
+   * @brief The handle for the empty string.
+   */
+  static constexpr Handle EMPTY = 0;
+
+  /**
+   * @brief Get the handle for str, adding it to the pool if not already there. The pool holds up to 65535 distinct
+   * strings. Running out means entities would lose their names and object IDs and get colliding topics, so it aborts.
+   */
+  Handle intern(std::string_view str);
+
+  /**
+   * @brief Get the string for a handle returned by intern(). The view is valid for the lifetime of the program.
+   */
+  std::string_view view(Handle handle) const {
+    return handle < _entries.size() ? _entries[handle] : std::string_view();
+  }
+
+  /**
+   * @brief Number of distinct strings in the pool, including the empty string.
+   */
+  size_t size() const { return _entries.size(); }
+
+  /**
+   * @brief Total number of bytes allocated for string data.
+   */
+  size_t bytes() const { return _bytes; }
+
+#ifdef HA_HAS_MEMORY_RESOURCE
+  /**
+   * @brief Set where to allocate chunks for new strings from, for example PSRAM. Chunks already allocated stay where
+   * they are. Global entities intern their strings when constructed, so to have these in the resource, set it from
+   * the constructor of a global declared before the entities (in the same file). Default is the global heap.
+   */
+  void setMemoryResource(std::pmr::memory_resource *resource) { _resource = resource; }
+#endif
+
+private:
+  struct Chunk {
+    char *data;
+    size_t size;
+#ifdef HA_HAS_MEMORY_RESOURCE
+    std::pmr::memory_resource *resource;
+#endif
+  };
+
+  char *allocate(size_t size);
+  void growIndex();
+
+private:
+  static constexpr size_t CHUNK_SIZE = 256;
+
+  std::vector<std::string_view> _entries = {std::string_view()};
+  std::vector<Handle> _index; // Open addressing hash table of handles into _entries, EMPTY for a free slot.
+  std::vector<Chunk> _chunks;
+  char *_chunk = nullptr; // Where the next short string goes in the current chunk.
+  size_t _chunk_left = 0;
+  size_t _bytes = 0;
+#ifdef HA_HAS_MEMORY_RESOURCE
+  std::pmr::memory_resource *_resource = nullptr;
+#endif
+};
+
+/**
+ * @brief The pool shared by all entities. Constructed on first use, so it can be used from the constructors of global
+ * entities.
+ */
+StringPool &stringPool();
+
+/**
+ * @brief A string in the stringPool(). Two bytes, cheap to copy, and converts to std::string_view.
+ */
+class InternedString {
+public:
+  InternedString() = default;
+  explicit InternedString(std::string_view str) : _handle(stringPool().intern(str)) {}
+
+  std::string_view view() const { return stringPool().view(_handle); }
+  operator std::string_view() const { return view(); }
+  bool empty() const { return _handle == StringPool::EMPTY; }
+
+private:
+  StringPool::Handle _handle = StringPool::EMPTY;
+};
+
+} // namespace homeassistantentities
+
+#endif // __HA_STRING_POOL_H__
@@ -0,0 +1,117 @@
+#include "HaTimerWheel.h"
+
+namespace homeassistantentities {
+
+TimerWheel::TimerWheel(size_t timers, uint32_t now)
+    : _now(now + 1), _nodes(timers < NONE ? timers : NONE, Node{.expires = 0, .prev = NONE, .next = NONE, .slot = NONE}) {
+  _heads.fill(NONE);
+}
+
+void TimerWheel::schedule(size_t timer, uint32_t delay) {
+  if (timer >= _nodes.size()) {
+    return;
+  }
+  unlink(static_cast<uint16_t>(timer));
+  _nodes[timer].expires = _now - 1 + delay;
+  insert(static_cast<uint16_t>(timer));
+}
+
+void TimerWheel::cancel(size_t timer) {
+  if (timer < _nodes.size()) {
+    unlink(static_cast<uint16_t>(timer));
+  }
+}
+
+void TimerWheel::insert(uint16_t timer) {
+  auto &node = _nodes[timer];
+  auto delta = static_cast<int32_t>(node.expires - _now);
+
+  // The level is given by how far away the timer is, the slot within the level by when it expires, so that the slot
+  // is reached (and moved down a level, see cascade()) just in time.
+  uint32_t slot;
+  if (delta <= 0) {
+    slot = _now & SLOT_MASK; // Overdue, in the slot processed next.
+  } else {
+    // Timers beyond the wheel are parked in the last level, at the furthest slot, and inserted again from there.
+    auto expires = static_cast<uint32_t>(delta) < SPAN ? node.expires : _now + SPAN - 1;
+    auto distance = expires - _now;
+    uint32_t level = 0;
+    while (level < LEVELS - 1 && distance >= (1u << (SLOT_BITS * (level + 1)))) {
+      level++;
+    }
+    slot = level * SLOTS + ((expires >> (SLOT_BITS * level)) & SLOT_MASK);
+  }
+
+  node.slot = static_cast<uint16_t>(slot);
+  node.prev = NONE;
+  node.next = _heads[slot];
+  if (node.next != NONE) {
+    _nodes[node.next].prev = timer;
+  }
+  _heads[slot] = timer;
+  _occupied[slot / SLOTS] |= uint64_t(1) << (slot % SLOTS);
+}
+
+void TimerWheel::unlink(uint16_t timer) {
+  auto &node = _nodes[timer];
+  if (node.slot == NONE) {
+    return;
+  }
+  if (node.prev != NONE) {
+    _nodes[node.prev].next = node.next;
+  } else {
+    _heads[node.slot] = node.next;
+    if (node.next == NONE) {
+      _occupied[node.slot / SLOTS] &= ~(uint64_t(1) << (node.slot % SLOTS));
+    }
+  }
+  if (node.next != NONE) {
+    _nodes[node.next].prev = node.prev;
+  }
+  node.slot = NONE;
+  node.prev = NONE;
+  node.next = NONE;
+}
+
+uint16_t TimerWheel::take(uint32_t slot) {
+  // Detach the whole list, so that timers inserted again while iterating it are not visited twice.
+  auto head = _heads[slot];
+  _heads[slot] = NONE;
+  _occupied[slot / SLOTS] &= ~(uint64_t(1) << (slot % SLOTS));
+  for (auto timer = head; timer != NONE; timer = _nodes[timer].next) {
+    _nodes[timer].slot = NONE;
+  }
+  return head;
+}
+
+void TimerWheel::cascade() {
+  // Called when level 0 wraps around. Move the timers of the current slot of level 1 down, and of the levels above
+  // when they wrap around too.
+  for (uint32_t level = 1; level < LEVELS; level++) {
+    auto index = (_now >> (SLOT_BITS * level)) & SLOT_MASK;
+    for (auto timer = take(level * SLOTS + index); timer != NONE;) {
+      auto next = _nodes[timer].next;
+      insert(timer);
+      timer = next;
+    }
+    if (index != 0) {
+      break;
+    }
+  }
+}
+
+uint32_t TimerWheel::nextTick(uint32_t now) const {
+  // Skip the empty slots of level 0 up to the next cascade, rather than visiting each tick.
+  auto next = _now + 1;
+  auto slot = next & SLOT_MASK;
+  if (slot != 0) {
+    auto occupied = _occupied[0] >> slot;
+    next += occupied != 0 ? static_cast<uint32_t>(__builtin_ctzll(occupied)) : SLOTS - slot;
+  }
+  if (static_cast<int32_t>(next - now) > 1) {
+    next = now + 1;
+  }
+  return next;
+}
+
+} // namespace homeassistantentities
@@ -0,0 +1,94 @@
+#ifndef __HA_TIMER_WHEEL_H__
+#define __HA_TIMER_WHEEL_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace homeassistantentities {
+
+/**
+ * @brief A hierarchical timer wheel, for a fixed number of timers identified by their index, like one for each entity
+ * of a HaEntityRegistry. Scheduling and cancelling a timer is O(1), and advancing the time only visits the timers that
+ * are due (plus moving timers down a level once per level), not every timer.
+ *
+ * Time is in ticks (milliseconds for the registry), as a wrapping 32 bit counter. There are 4 levels of 64 slots, so
+ * the wheel spans 2^24 ticks (about 4.6 hours of milliseconds). Timers further away are parked in the last level and
+ * rescheduled when their slot comes around, so delays up to 2^31 ticks work.
+ *
+ * Not thread safe, the owner locks.
+ */
+class TimerWheel {
+public:
+  /**
+   * @param timers number of timers, at most 65535.
+   * @param now the current time, in ticks.
+   */
+  TimerWheel(size_t timers, uint32_t now);
+
+  /**
+   * @brief Schedule (or reschedule) a timer to be due delay ticks after the time of the last advance() (or the time
+   * given to the constructor).
+   */
+  void schedule(size_t timer, uint32_t delay);
+
+  /**
+   * @brief Stop a timer. Does nothing if not scheduled.
+   */
+  void cancel(size_t timer);
+
+  /**
+   * @brief Advance the time to now, and call due(timer) for each timer that is due. The timers are no longer
+   * scheduled when due() is called. due() must not schedule or cancel timers, collect them and reschedule afterwards.
+   */
+  template <typename F> void advance(uint32_t now, F &&due) {
+    while (static_cast<int32_t>(now - _now) >= 0) {
+      auto slot = _now & SLOT_MASK;
+      if (slot == 0) {
+        cascade();
+      }
+      for (auto timer = take(slot); timer != NONE;) {
+        auto next = _nodes[timer].next;
+        if (static_cast<int32_t>(_nodes[timer].expires - _now) > 0) {
+          insert(timer); // Not due yet, see insert().
+        } else {
+          due(static_cast<size_t>(timer));
+        }
+        timer = next;
+      }
+      _now = nextTick(now);
+    }
+  }
+
+private:
+  static constexpr uint16_t NONE = UINT16_MAX;
+  static constexpr uint32_t SLOT_BITS = 6;
+  static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+  static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+  static constexpr uint32_t LEVELS = 4;
+  static constexpr uint32_t SPAN = 1 << (SLOT_BITS * LEVELS); // Ticks covered by all levels.
+
+  struct Node {
+    uint32_t expires;
+    uint16_t prev;
+    uint16_t next;
+    uint16_t slot; // Index in _heads, or NONE if not scheduled.
+  };
+
+  void insert(uint16_t timer);
+  void unlink(uint16_t timer);
+  uint16_t take(uint32_t slot);
+  void cascade();
+  uint32_t nextTick(uint32_t now) const;
+
+private:
+  uint32_t _now; // The next tick to process, one after the time of the last advance().
+  std::vector<Node> _nodes;
+  std::array<uint16_t, LEVELS * SLOTS> _heads;   // First timer in each slot, level by level.
+  std::array<uint64_t, LEVELS> _occupied = {};   // One bit for each slot with timers.
+};
+
+} // namespace homeassistantentities
+
+#endif // __HA_TIMER_WHEEL_H__
@@ -0,0 +1,90 @@
+#include "HaTimestampFormat.h"
+#include <HaSpinLock.h>
+#include <cstring>
+#include <mutex>
+
+#define DATE_LENGTH 10 // "YYYY-MM-DD"
+#define MS_PER_DAY 86400000LL
+
+namespace homeassistantentities {
+
+// Division rounding towards negative infinity, for times before the epoch.
+static int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+static void writeDigits(char *buffer, uint32_t value, size_t digits) {
+  for (size_t i = digits; i > 0; i--) {
+    buffer[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+// Days since the epoch to "YYYY-MM-DD", see http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+static void writeDate(char *buffer, int64_t days) {
+  days += 719468;
+  int64_t era = floorDiv(days, 146097);
+  auto day_of_era = static_cast<uint32_t>(days - era * 146097);
+  uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  uint32_t month_index = (5 * day_of_year + 2) / 153; // March is 0.
+  uint32_t day = day_of_year - (153 * month_index + 2) / 5 + 1;
+  uint32_t month = month_index < 10 ? month_index + 3 : month_index - 9;
+  int64_t year = static_cast<int64_t>(year_of_era) + era * 400 + (month <= 2);
+
+  writeDigits(buffer, static_cast<uint32_t>(year < 0 ? 0 : (year > 9999 ? 9999 : year)), 4);
+  buffer[4] = '-';
+  writeDigits(buffer + 5, month, 2);
+  buffer[7] = '-';
+  writeDigits(buffer + 8, day, 2);
+}
+
+size_t formatTimestamp(char *buffer, int64_t epoch_ms, bool with_milliseconds, int16_t utc_offset_minutes) {
+  static SpinLock lock;
+  static int64_t cached_day = INT64_MIN;
+  static char cached_date[DATE_LENGTH];
+
+  int64_t local_ms = epoch_ms + static_cast<int64_t>(utc_offset_minutes) * 60000;
+  int64_t day = floorDiv(local_ms, MS_PER_DAY);
+  auto ms_of_day = static_cast<uint32_t>(local_ms - day * MS_PER_DAY);
+
+  {
+    std::lock_guard<SpinLock> guard(lock);
+    if (day != cached_day) {
+      writeDate(cached_date, day);
+      cached_day = day;
+    }
+    memcpy(buffer, cached_date, DATE_LENGTH);
+  }
+
+  char *p = buffer + DATE_LENGTH;
+  *p++ = 'T';
+  writeDigits(p, ms_of_day / 3600000, 2);
+  p += 2;
+  *p++ = ':';
+  writeDigits(p, ms_of_day / 60000 % 60, 2);
+  p += 2;
+  *p++ = ':';
+  writeDigits(p, ms_of_day / 1000 % 60, 2);
+  p += 2;
+  if (with_milliseconds) {
+    *p++ = '.';
+    writeDigits(p, ms_of_day % 1000, 3);
+    p += 3;
+  }
+
+  uint32_t offset = utc_offset_minutes < 0 ? -utc_offset_minutes : utc_offset_minutes;
+  *p++ = utc_offset_minutes < 0 ? '-' : '+';
+  writeDigits(p, offset / 60 % 100, 2);
+  p += 2;
+  *p++ = ':';
+  writeDigits(p, offset % 60, 2);
+  p += 2;
+
+  return p - buffer;
+}
+
+std::string formatTimestamp(int64_t epoch_ms, bool with_milliseconds, int16_t utc_offset_minutes) {
+  char buffer[MAX_TIMESTAMP_LENGTH];
+  return std::string(buffer, formatTimestamp(buffer, epoch_ms, with_milliseconds, utc_offset_minutes));
+}
+
+}; // namespace homeassistantentities
@@ -0,0 +1,36 @@
+#ifndef __HA_TIMESTAMP_FORMAT_H__
+#define __HA_TIMESTAMP_FORMAT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace homeassistantentities {
+
+/**
+ * @brief Longest timestamp formatTimestamp() writes, "YYYY-MM-DDTHH:MM:SS.mmm+HH:MM", not including a null terminator.
+ */
+constexpr size_t MAX_TIMESTAMP_LENGTH = 29;
+
+/**
+ * @brief Format a time since the Unix epoch as an ISO 8601 timestamp, like "2024-05-17T13:37:00+02:00". This does not
+ * use the C library time functions or the locale. The date part is cached and reused while the day is the same, so
+ * formatting many timestamps for the same day is only some integer arithmetic. Years outside 0 to 9999 are not
+ * supported. Thread safe.
+ *
+ * @param buffer where to write the timestamp, at least MAX_TIMESTAMP_LENGTH bytes. Not null terminated.
+ * @param epoch_ms milliseconds since the Unix epoch, in UTC.
+ * @param with_milliseconds if true, include milliseconds (".mmm") in the timestamp.
+ * @param utc_offset_minutes the offset from UTC for the time zone to format in, like 120 for +02:00.
+ * @returns the number of characters written.
+ */
+size_t formatTimestamp(char *buffer, int64_t epoch_ms, bool with_milliseconds, int16_t utc_offset_minutes = 0);
+
+/**
+ * @brief Same as above, but returns a string.
+ */
+std::string formatTimestamp(int64_t epoch_ms, bool with_milliseconds, int16_t utc_offset_minutes = 0);
+
+}; // namespace homeassistantentities
+
+#endif // __HA_TIMESTAMP_FORMAT_H__
@@ -0,0 +1,102 @@
+#include "HaTopicAliases.h"
+
+HaTopicAliases::HaTopicAliases(uint16_t capacity)
+    : _capacity(capacity), _entries(std::make_unique<Entry[]>(capacity)) {
+  _aliases.reserve(capacity);
+}
+
+void HaTopicAliases::reset(uint32_t connection, uint16_t maximum) {
+  for (uint16_t alias = 1; alias <= _used; alias++) {
+    entry(alias).topic.clear();
+  }
+  _aliases.clear();
+  _maximum = maximum < _capacity ? maximum : _capacity;
+  _used = 0;
+  _first = NONE;
+  _last = NONE;
+  _connection = connection;
+}
+
+uint16_t HaTopicAliases::alias(std::string_view topic, bool &assigned) {
+  assigned = false;
+  if (_maximum == 0) {
+    return NONE;
+  }
+
+  if (auto it = _aliases.find(topic); it != _aliases.end()) {
+    auto alias = it->second;
+    unlink(alias);
+    pushFront(alias);
+    return alias;
+  }
+
+  // Take a never used alias, else the least recently used one.
+  uint16_t alias;
+  if (_used < _maximum) {
+    alias = ++_used;
+  } else {
+    alias = _last;
+    unlink(alias);
+    auto &taken = entry(alias);
+    if (!taken.topic.empty()) {
+      _aliases.erase(taken.topic);
+    }
+  }
+
+  auto &assign = entry(alias);
+  assign.topic.assign(topic.data(), topic.size());
+  _aliases.emplace(assign.topic, alias);
+  pushFront(alias);
+  assigned = true;
+  return alias;
+}
+
+void HaTopicAliases::forget(uint16_t alias) {
+  if (alias == NONE || alias > _used) {
+    return;
+  }
+  auto &forgotten = entry(alias);
+  if (!forgotten.topic.empty()) {
+    _aliases.erase(forgotten.topic);
+    forgotten.topic.clear();
+  }
+
+  // Last in line, so it is taken first.
+  unlink(alias);
+  forgotten.prev = _last;
+  forgotten.next = NONE;
+  if (_last != NONE) {
+    entry(_last).next = alias;
+  } else {
+    _first = alias;
+  }
+  _last = alias;
+}
+
+void HaTopicAliases::unlink(uint16_t alias) {
+  auto &unlinked = entry(alias);
+  if (unlinked.prev != NONE) {
+    entry(unlinked.prev).next = unlinked.next;
+  } else if (_first == alias) {
+    _first = unlinked.next;
+  }
+  if (unlinked.next != NONE) {
+    entry(unlinked.next).prev = unlinked.prev;
+  } else if (_last == alias) {
+    _last = unlinked.prev;
+  }
+  unlinked.prev = NONE;
+  unlinked.next = NONE;
+}
+
+void HaTopicAliases::pushFront(uint16_t alias) {
+  auto &pushed = entry(alias);
+  pushed.prev = NONE;
+  pushed.next = _first;
+  if (_first != NONE) {
+    entry(_first).prev = alias;
+  } else {
+    _last = alias;
+  }
+  _first = alias;
+}
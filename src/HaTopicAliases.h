@@ -0,0 +1,75 @@
+#ifndef __HA_TOPIC_ALIASES_H__
+#define __HA_TOPIC_ALIASES_H__
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief The topic aliases of one MQTT 5 connection, assigned to the most recently published topics. Used by HaBridge
+ * with setTopicAliases(). When all aliases are in use, the least recently published topic gives its alias to the new
+ * topic, so frequently updated states keep theirs. Looking up and reassigning an alias is O(1).
+ *
+ * Not thread safe. HaBridge only uses it from the task publishing to the MQTT client.
+ */
+class HaTopicAliases {
+public:
+  /**
+   * @param capacity maximum number of aliases, whatever the broker accepts.
+   */
+  explicit HaTopicAliases(uint16_t capacity);
+
+  /**
+   * @brief Forget all aliases, for a new connection.
+   *
+   * @param connection number of the new connection, see IMQTTRemoteTopicAlias::connectionNumber().
+   * @param maximum Topic Alias Maximum of the broker for the new connection.
+   */
+  void reset(uint32_t connection, uint16_t maximum);
+
+  /**
+   * @brief true if connection was given to the last reset().
+   */
+  bool isCurrent(uint32_t connection) const { return _connection == connection; }
+
+  /**
+   * @brief Get the alias for topic, assigning one if it has none.
+   *
+   * @param assigned set to true if the alias was just assigned, and must be sent with the topic.
+   * @returns the alias, or 0 if none (the broker does not support aliases).
+   */
+  uint16_t alias(std::string_view topic, bool &assigned);
+
+  /**
+   * @brief Forget an alias, like when publishing the message assigning it failed.
+   */
+  void forget(uint16_t alias);
+
+private:
+  static constexpr uint16_t NONE = 0;
+
+  struct Entry {
+    std::string topic; // Empty if the alias is free.
+    uint16_t prev;     // More recently used, or NONE.
+    uint16_t next;     // Less recently used, or NONE.
+  };
+
+  Entry &entry(uint16_t alias) { return _entries[alias - 1]; }
+  void unlink(uint16_t alias);
+  void pushFront(uint16_t alias);
+
+private:
+  uint16_t _capacity;
+  uint16_t _maximum = 0; // Aliases 1 to _maximum are used.
+  uint16_t _used = 0;    // Aliases 1 to _used have been assigned.
+  uint16_t _first = NONE; // Most recently used.
+  uint16_t _last = NONE;  // Least recently used, or forgotten.
+  std::optional<uint32_t> _connection;
+  std::unique_ptr<Entry[]> _entries;
+  std::unordered_map<std::string_view, uint16_t> _aliases; // Views into Entry::topic.
+};
+
+#endif // __HA_TOPIC_ALIASES_H__
@@ -3,32 +3,71 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <string>
+#include <string_view>
+
+// std::pmr is not available on older toolchains, like GCC 8 in ESP-IDF 4.4.
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define HA_HAS_MEMORY_RESOURCE
+#endif
 
 namespace homeassistantentities {
 
-inline std::string trim(const std::string &str) {
+// Fixed payloads, published as is without building a string.
+constexpr std::string_view PAYLOAD_ON = "ON";
+constexpr std::string_view PAYLOAD_OFF = "OFF";
+
+/**
+ * @brief Same as trim(), but returns a view into str instead of a copy.
+ */
+inline std::string_view trimView(std::string_view str) {
   auto first = std::find_if_not(str.begin(), str.end(), [](int c) { return std::isspace(c); });
   auto last = std::find_if_not(str.rbegin(), str.rend(), [](int c) { return std::isspace(c); }).base();
-  return (first == last ? std::string() : std::string(first, last));
+  return first >= last ? std::string_view() : str.substr(first - str.begin(), last - first);
 }
 
+inline std::string trim(std::string_view str) { return std::string(trimView(str)); }
+
 /**
- * @brief Given a string that is supposed to be in an MQTT path, return a valid path. Only [a-zA-Z0-9_-] are allowed.
- * Everyting else is replaced by _.
+ * @brief Append str to result, replacing characters that are not valid in an MQTT path. Only [a-zA-Z0-9_-] are
+ * allowed. Everyting else is replaced by _.
  */
-inline std::string santitizePath(const std::string &str) {
-  std::string result;
+inline void appendSantitizedPath(std::string &result, std::string_view str) {
   for (char c : str) {
-    if (std::isalnum(c) || c == '-' || c == '_') {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_') {
       result += c;
     } else {
       result += '_';
     }
   }
+}
+
+/**
+ * @brief Given a string that is supposed to be in an MQTT path, return a valid path. Only [a-zA-Z0-9_-] are allowed.
+ * Everyting else is replaced by _.
+ */
+inline std::string santitizePath(std::string_view str) {
+  std::string result;
+  result.reserve(str.size());
+  appendSantitizedPath(result, str);
   return result;
 }
 
+/**
+ * @brief 32 bit FNV-1a hash of str. Stable across builds and platforms, so it can be used for things like spreading
+ * nodes out in time based on their client ID.
+ *
+ * @param hash the hash so far, to hash several strings in sequence.
+ */
+constexpr uint32_t fnv1a(std::string_view str, uint32_t hash = 2166136261u) {
+  for (char c : str) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
 }; // namespace homeassistantentities
 
 #endif // __HA_UTILITIES_H__
\ No newline at end of file
@@ -0,0 +1,237 @@
+#ifndef __I_HA_STORAGE_H__
+#define __I_HA_STORAGE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief Storage that survives deep sleep or restarts, like RTC memory, NVS or a file. The battery mode of
+ * HaEntityRegistry stores one small blob, and snapshots of the entity states store one record per entity. The registry
+ * validates what it loads, so the storage does not need to handle uninitialized memory.
+ */
+class IHaStorage {
+public:
+  virtual ~IHaStorage() = default;
+
+  /**
+   * @brief Read the stored blob.
+   *
+   * @param data where to read to.
+   * @param size size of data.
+   * @returns the number of bytes read, or 0 if nothing is stored.
+   */
+  virtual size_t load(void *data, size_t size) = 0;
+
+  /**
+   * @brief Replace the stored blob.
+   *
+   * @returns true on success, or false on failure.
+   */
+  virtual bool save(const void *data, size_t size) = 0;
+
+  /**
+   * @brief Read the record stored for key, for snapshots of the entity states (see HaEntityRegistry::saveSnapshot()).
+   * The default, for storages with only one blob, has no records.
+   *
+   * @param key identifies the record.
+   * @param data where to read to.
+   * @param size size of data.
+   * @returns the size of the record, or 0 if nothing is stored for key. If larger than size, nothing was read, and the
+   * caller can retry with a larger buffer.
+   */
+  virtual size_t loadRecord(uint32_t key, void *data, size_t size) { return 0; }
+
+  /**
+   * @brief Replace the record stored for key.
+   *
+   * @returns true on success, or false on failure.
+   */
+  virtual bool saveRecord(uint32_t key, const void *data, size_t size) { return false; }
+};
+
+/**
+ * @brief IHaStorage in a buffer owned by the caller, for memory that is kept during deep sleep. For example on ESP32:
+ *
+ *   RTC_DATA_ATTR uint8_t rtc_buffer[512];
+ *   HaBufferStorage storage(rtc_buffer, sizeof(rtc_buffer));
+ *
+ * The first 4 bytes of the buffer hold the size of the blob.
+ */
+class HaBufferStorage : public IHaStorage {
+public:
+  HaBufferStorage(void *buffer, size_t size) : _buffer(static_cast<uint8_t *>(buffer)), _size(size) {}
+
+  size_t load(void *data, size_t size) override {
+    uint32_t stored;
+    if (_size < sizeof(stored)) {
+      return 0;
+    }
+    std::memcpy(&stored, _buffer, sizeof(stored));
+    if (stored > _size - sizeof(stored) || stored > size) {
+      return 0;
+    }
+    std::memcpy(data, _buffer + sizeof(stored), stored);
+    return stored;
+  }
+
+  bool save(const void *data, size_t size) override {
+    uint32_t stored = static_cast<uint32_t>(size);
+    if (_size < sizeof(stored) || size > _size - sizeof(stored)) {
+      return false;
+    }
+    std::memcpy(_buffer, &stored, sizeof(stored));
+    std::memcpy(_buffer + sizeof(stored), data, size);
+    return true;
+  }
+
+private:
+  uint8_t *_buffer;
+  size_t _size;
+};
+
+/**
+ * @brief IHaStorage in files, one for the blob and one for each record, in a directory that must exist. For a host, or
+ * an ESP32 with a mounted file system like LittleFS (with a path in the VFS, like "/littlefs/ha"). Each file is written
+ * to a temporary file first and then renamed, so a failed save keeps what was stored before.
+ */
+class HaFileStorage : public IHaStorage {
+public:
+  explicit HaFileStorage(std::string directory) : _directory(std::move(directory)) {}
+
+  size_t load(void *data, size_t size) override {
+    auto stored = read(path("blob"), data, size);
+    return stored <= size ? stored : 0;
+  }
+
+  bool save(const void *data, size_t size) override { return write(path("blob"), data, size); }
+
+  size_t loadRecord(uint32_t key, void *data, size_t size) override { return read(recordPath(key), data, size); }
+
+  bool saveRecord(uint32_t key, const void *data, size_t size) override {
+    return write(recordPath(key), data, size);
+  }
+
+private:
+  std::string path(const char *name) const { return _directory + "/" + name; }
+
+  std::string recordPath(uint32_t key) const {
+    char name[12];
+    std::snprintf(name, sizeof(name), "r%08lx", static_cast<unsigned long>(key));
+    return path(name);
+  }
+
+  // Returns the size of the file, only read if it fits in size.
+  static size_t read(const std::string &path, void *data, size_t size) {
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+      return 0;
+    }
+    size_t stored = 0;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+      auto end = std::ftell(file);
+      stored = end > 0 ? static_cast<size_t>(end) : 0;
+    }
+    if (stored > 0 && stored <= size) {
+      std::rewind(file);
+      if (std::fread(data, 1, stored, file) != stored) {
+        stored = 0;
+      }
+    }
+    std::fclose(file);
+    return stored;
+  }
+
+  static bool write(const std::string &path, const void *data, size_t size) {
+    auto temporary = path + ".tmp";
+    FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    bool ok = std::fwrite(data, 1, size, file) == size;
+    ok = std::fclose(file) == 0 && ok;
+    // rename() does not replace an existing file on every platform.
+    if (ok && std::rename(temporary.c_str(), path.c_str()) != 0) {
+      std::remove(path.c_str());
+      ok = std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+    if (!ok) {
+      std::remove(temporary.c_str());
+    }
+    return ok;
+  }
+
+private:
+  std::string _directory;
+};
+
+#if __has_include(<nvs.h>)
+#include <nvs.h>
+
+/**
+ * @brief IHaStorage in NVS (non-volatile storage) on ESP32, which survives restarts, in its own namespace. NVS must
+ * have been initialized, see nvs_flash_init(). Each save is committed to flash, which wears with writes, so save a
+ * snapshot when states changed rather than on every update.
+ */
+class HaNvsStorage : public IHaStorage {
+public:
+  explicit HaNvsStorage(const char *name_space = "ha_entities") {
+    if (nvs_open(name_space, NVS_READWRITE, &_handle) != ESP_OK) {
+      _handle = 0;
+    }
+  }
+
+  ~HaNvsStorage() {
+    if (_handle != 0) {
+      nvs_close(_handle);
+    }
+  }
+
+  HaNvsStorage(const HaNvsStorage &) = delete;
+  HaNvsStorage &operator=(const HaNvsStorage &) = delete;
+
+  size_t load(void *data, size_t size) override { return get(BLOB_KEY, data, size); }
+  bool save(const void *data, size_t size) override { return set(BLOB_KEY, data, size); }
+
+  size_t loadRecord(uint32_t key, void *data, size_t size) override {
+    char name[12];
+    return get(recordKey(key, name), data, size);
+  }
+
+  bool saveRecord(uint32_t key, const void *data, size_t size) override {
+    char name[12];
+    return set(recordKey(key, name), data, size);
+  }
+
+private:
+  static constexpr const char *BLOB_KEY = "blob";
+
+  static const char *recordKey(uint32_t key, char (&name)[12]) {
+    // NVS keys are at most 15 characters.
+    std::snprintf(name, sizeof(name), "r%08lx", static_cast<unsigned long>(key));
+    return name;
+  }
+
+  size_t get(const char *key, void *data, size_t size) {
+    size_t stored = 0;
+    if (_handle == 0 || nvs_get_blob(_handle, key, nullptr, &stored) != ESP_OK) {
+      return 0;
+    }
+    if (stored > size) {
+      return stored;
+    }
+    return nvs_get_blob(_handle, key, data, &stored) == ESP_OK ? stored : 0;
+  }
+
+  bool set(const char *key, const void *data, size_t size) {
+    return _handle != 0 && nvs_set_blob(_handle, key, data, size) == ESP_OK && nvs_commit(_handle) == ESP_OK;
+  }
+
+private:
+  nvs_handle_t _handle = 0;
+};
+#endif
+
+#endif // __I_HA_STORAGE_H__
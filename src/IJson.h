@@ -25,6 +25,20 @@
 
 #define addToJsonArray(doc, value) doc.push_back(value)
 
+// Parse a JSON string into doc, evaluates to false if the string is not valid JSON.
+#define parseJsonString(doc, str) (!(doc = nlohmann::json::parse(str, nullptr, false)).is_discarded())
+
+#define isJsonObject(value) value.is_object()
+
+#define isJsonString(value) value.is_string()
+
+#define isJsonNumber(value) value.is_number()
+
+#define isJsonBool(value) value.is_boolean()
+
+// Only use after checking the type with one of the above.
+#define getJsonValue(value, type) value.get<type>()
+
 #elif __has_include("ArduinoJson.h")
 #include <ArduinoJson.h>
 
@@ -42,6 +56,25 @@
 
 #define addToJsonArray(doc, value) doc.add(value)
 
+// Parse a JSON string into doc, evaluates to false if the string is not valid JSON.
+#define parseJsonString(doc, str) (deserializeJson(doc, str) == DeserializationError::Ok)
+
+#define isJsonObject(value) value.is<JsonObject>()
+
+#define isJsonString(value) value.is<const char *>()
+
+#define isJsonNumber(value) value.is<double>()
+
+#define isJsonBool(value) value.is<bool>()
+
+// Only use after checking the type with one of the above.
+#define getJsonValue(value, type) value.as<type>()
+
+// Documents can be created with a custom allocator, IJsonDocument(IJsonAllocator *).
+#define IJSON_SUPPORTS_ALLOCATOR
+
+#define IJsonAllocator ArduinoJson::Allocator
+
 #else
 #error                                                                                                                 \
     "No JSON library found. You need to install either https://github.com/Johboh/nlohmann-json OR https://github.com/bblanchon/ArduinoJson, see README.md"
@@ -0,0 +1,62 @@
+#ifndef __I_MQTT_REMOTE_EXTENDED_H__
+#define __I_MQTT_REMOTE_EXTENDED_H__
+
+#include "IMQTTRemote.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Optional extension to IMQTTRemote for MQTT clients that can publish directly from a topic and message they do
+ * not own, like most C MQTT clients taking a pointer and a length. IMQTTRemote::publishMessage() takes std::string by
+ * value, so every topic and payload is copied on the way to the client. Implement this interface in the MQTT client
+ * and pass it to HaBridge::setRemoteExtended() to avoid the copies.
+ *
+ * IMQTTRemote.h is kept as a copy of the upstream interface, so this is a separate interface rather than new methods
+ * there.
+ */
+class IMQTTRemoteExtended {
+public:
+  virtual ~IMQTTRemoteExtended() = default;
+
+  /**
+   * @brief Publish a message. Same as IMQTTRemote::publishMessage(), but the topic and message are only valid during
+   * the call.
+   *
+   * @param topic the topic to publish to.
+   * @param message The message to send.
+   * @param retain True to set this message as retained.
+   * @param qos quality of service for published message (0 (default), 1 or 2)
+   * @returns true on success, or false on failure.
+   */
+  virtual bool publish(std::string_view topic, std::string_view message, bool retain = false, uint8_t qos = 0) = 0;
+
+  /**
+   * Same as publish(), but will print the message and topic and the result in console.
+   */
+  virtual bool publishVerbose(std::string_view topic, std::string_view message, bool retain = false,
+                              uint8_t qos = 0) = 0;
+};
+
+/**
+ * @brief The default IMQTTRemoteExtended used by HaBridge, publishing through a plain IMQTTRemote. Copies the topic
+ * and the message into std::string, as required by IMQTTRemote::publishMessage().
+ */
+class MQTTRemoteExtendedAdapter : public IMQTTRemoteExtended {
+public:
+  explicit MQTTRemoteExtendedAdapter(IMQTTRemote &remote) : _remote(remote) {}
+
+  bool publish(std::string_view topic, std::string_view message, bool retain = false, uint8_t qos = 0) override {
+    return _remote.publishMessage(std::string(topic), std::string(message), retain, qos);
+  }
+
+  bool publishVerbose(std::string_view topic, std::string_view message, bool retain = false,
+                      uint8_t qos = 0) override {
+    return _remote.publishMessageVerbose(std::string(topic), std::string(message), retain, qos);
+  }
+
+private:
+  IMQTTRemote &_remote;
+};
+
+#endif // __I_MQTT_REMOTE_EXTENDED_H__
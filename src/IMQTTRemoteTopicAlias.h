@@ -0,0 +1,46 @@
+#ifndef __I_MQTT_REMOTE_TOPIC_ALIAS_H__
+#define __I_MQTT_REMOTE_TOPIC_ALIAS_H__
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Optional extension to IMQTTRemote for MQTT 5 clients supporting topic aliases. With a topic alias, a publish
+ * carries a 2 byte number instead of the topic, once the alias has been assigned to the topic by a publish carrying
+ * both. State topics are often longer than their payload, so this saves most of the bytes of frequent updates.
+ * Implement this interface in the MQTT client and pass it to HaBridge::setTopicAliases().
+ *
+ * Aliases only live for one connection, and the broker tells how many it accepts in its CONNACK (Topic Alias
+ * Maximum).
+ */
+class IMQTTRemoteTopicAlias {
+public:
+  virtual ~IMQTTRemoteTopicAlias() = default;
+
+  /**
+   * @brief Number of the current connection to the broker. Must change on every (re)connect, as the aliases are then
+   * forgotten by the broker.
+   */
+  virtual uint32_t connectionNumber() = 0;
+
+  /**
+   * @brief The Topic Alias Maximum of the broker for the current connection, or 0 if topic aliases are not supported
+   * (like with MQTT 3.1.1).
+   */
+  virtual uint16_t topicAliasMaximum() = 0;
+
+  /**
+   * @brief Publish a message with a topic alias.
+   *
+   * @param topic the topic to assign alias to, or empty to publish to the topic alias was assigned to before.
+   * @param alias the topic alias, from 1 to topicAliasMaximum().
+   * @param message The message to send.
+   * @param retain True to set this message as retained.
+   * @param qos quality of service for published message (0 (default), 1 or 2)
+   * @returns true on success, or false on failure.
+   */
+  virtual bool publishAliased(std::string_view topic, uint16_t alias, std::string_view message, bool retain = false,
+                              uint8_t qos = 0) = 0;
+};
+
+#endif // __I_MQTT_REMOTE_TOPIC_ALIAS_H__
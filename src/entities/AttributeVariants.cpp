@@ -2,7 +2,7 @@
 
 namespace Attributes {
 
-void addValue(IJsonDocument &doc, std::string key, Attributes::Variants value) {
+void addValue(IJsonDocument &doc, const std::string &key, const Attributes::Variants &value) {
   if (std::holds_alternative<double>(value)) {
     doc[key] = std::get<double>(value);
   } else if (std::holds_alternative<float>(value)) {
@@ -26,9 +26,9 @@ void addValue(IJsonDocument &doc, std::string key, Attributes::Variants value) {
   }
 }
 
-void addKeyValue(IJsonDocument &doc, std::string key, Attributes::Variants value) {
+void addKeyValue(IJsonDocument &doc, const std::string &key, const Attributes::Variants &value) {
   if (std::holds_alternative<Attributes::InnerSet>(value)) {
-    auto set = std::get<Attributes::InnerSet>(value);
+    const auto &set = std::get<Attributes::InnerSet>(value);
     JsonArrayType array = createJsonArray(doc, key);
     for (const auto &value : set) {
       IJsonDocument temp_doc;
@@ -40,21 +40,37 @@ void addKeyValue(IJsonDocument &doc, std::string key, Attributes::Variants value
   }
 }
 
-bool toJson(IJsonDocument &doc, Attributes::Map attributes, std::set<std::string> forbidden_keys) {
+bool toJson(IJsonDocument &doc, const Attributes::Map &attributes, const std::set<std::string> &forbidden_keys) {
   // Add known attributes.
   auto size_before = doc.size();
   for (const auto &attribute : attributes) {
     // Keys with name "event_type" is not allowed.
-    auto key = attribute.first;
+    const auto &key = attribute.first;
 
     if (forbidden_keys.find(key) != forbidden_keys.end()) {
       continue;
     }
 
-    auto value = attribute.second;
-    addKeyValue(doc, key, value);
+    addKeyValue(doc, key, attribute.second);
   }
   return doc.size() > size_before;
 }
 
+bool fromJson(const IJsonDocument &doc, Attributes::Map &attributes) {
+  if (!isJsonObject(doc)) {
+    return false;
+  }
+  for (auto kv : IJsonConstIteratorBegin(doc)) {
+    std::string key(kv.key().c_str());
+    if (isJsonBool(kv.value())) {
+      attributes[key] = getJsonValue(kv.value(), bool);
+    } else if (isJsonNumber(kv.value())) {
+      attributes[key] = getJsonValue(kv.value(), double);
+    } else if (isJsonString(kv.value())) {
+      attributes[key] = getJsonValue(kv.value(), std::string);
+    }
+  }
+  return true;
+}
+
 } // namespace Attributes
@@ -13,7 +13,11 @@ using Variants =
     std::variant<uint64_t, uint32_t, uint16_t, uint8_t, int, float, double, bool, std::string, const char *, InnerSet>;
 using Map = std::map<std::string, Variants>;
 
-bool toJson(IJsonDocument &doc, Attributes::Map attributes, std::set<std::string> forbidden_keys = {});
+bool toJson(IJsonDocument &doc, const Attributes::Map &attributes, const std::set<std::string> &forbidden_keys = {});
+
+// Back from a JSON object created by toJson(), like a retained state. Numbers come back as double, sets are skipped.
+// Returns false if doc is not an object.
+bool fromJson(const IJsonDocument &doc, Attributes::Map &attributes);
 
 }; // namespace Attributes
 
@@ -1,13 +1,21 @@
 #pragma once
 
-#include "HaUtilities.h"
+#include <cstddef>
 #include <optional>
-#include <string>
+#include <string_view>
 
 namespace homeassistantentities {
 
 using UnitType = int;
 
+/**
+ * @brief A Home Assistant device class, its sensor type and the units of measurement it supports. All device classes
+ * below are constexpr, backed by static string tables, with no virtual functions and no allocations. The units of a
+ * device class are indexed by its Unit enum, starting at 1.
+ *
+ * A custom device class can be created by subclassing and passing the device class and units to the constructor, in
+ * the same way as the device classes below.
+ */
 class DeviceClass {
 public:
   enum class SensorType {
@@ -16,23 +24,88 @@ public:
   };
 
 public:
-  virtual ~DeviceClass() = default;
-  virtual SensorType sensorType() const = 0;
-  virtual std::optional<std::string> deviceClass() const = 0;
-  virtual std::optional<std::string> unitOfMeasurement(UnitType unit) const = 0;
+  /**
+   * @param sensor_type the sensor type.
+   * @param device_class the Home Assistant device class, or empty for no device class.
+   * @param object_id the object ID to use in topics. If empty, the device class is used.
+   */
+  constexpr DeviceClass(SensorType sensor_type, std::string_view device_class, std::string_view object_id = {})
+      : _sensor_type(sensor_type), _device_class(device_class), _object_id(object_id), _units(nullptr),
+        _num_units(0) {}
+
+  /**
+   * @param sensor_type the sensor type.
+   * @param device_class the Home Assistant device class, or empty for no device class.
+   * @param units the units, where the unit with UnitType 1 is at index 0. Must have static storage duration. An empty
+   * unit means no unit of measurement.
+   * @param object_id the object ID to use in topics. If empty, the device class is used.
+   */
+  template <size_t N>
+  constexpr DeviceClass(SensorType sensor_type, std::string_view device_class, const std::string_view (&units)[N],
+                        std::string_view object_id = {})
+      : _sensor_type(sensor_type), _device_class(device_class), _object_id(object_id), _units(units),
+        _num_units(N) {}
+
+  constexpr SensorType sensorType() const { return _sensor_type; }
+
+  /**
+   * @brief The Home Assistant device class, or std::nullopt if none.
+   */
+  constexpr std::optional<std::string_view> deviceClass() const {
+    if (_device_class.empty()) {
+      return std::nullopt;
+    }
+    return _device_class;
+  }
+
+  /**
+   * @brief The unit of measurement for the given unit, or std::nullopt if the unit is not supported by this device
+   * class.
+   */
+  constexpr std::optional<std::string_view> unitOfMeasurement(UnitType unit) const {
+    if (unit < 1 || static_cast<size_t>(unit) > _num_units || _units[unit - 1].empty()) {
+      return std::nullopt;
+    }
+    return _units[unit - 1];
+  }
 
-  virtual std::string objectId() const {
-    auto device_class_opt = deviceClass();
-    if (device_class_opt) {
-      auto device_class = trim(*device_class_opt);
-      if (!device_class.empty()) {
-        return device_class;
-      }
+  /**
+   * @brief The object ID used in topics for entities using this device class.
+   */
+  constexpr std::string_view objectId() const {
+    if (!_object_id.empty()) {
+      return _object_id;
+    } else if (!_device_class.empty()) {
+      return _device_class;
     }
     return "unknown_device_class";
   }
+
+private:
+  SensorType _sensor_type;
+  std::string_view _device_class;
+  std::string_view _object_id;
+  const std::string_view *_units;
+  size_t _num_units;
 };
 
+/**
+ * @brief Compile time lookup of the unit of measurement for a device class. Example:
+ * unitOf<Sensor::Temperature>(Sensor::Temperature::Unit::C) == "°C". Returns an empty string if the unit has no
+ * unit of measurement.
+ */
+template <typename T> constexpr std::string_view unitOf(typename T::Unit unit) {
+  return T().unitOfMeasurement(unit).value_or(std::string_view());
+}
+
+/**
+ * @brief Compile time lookup of the Home Assistant device class for a device class. Example:
+ * deviceClassOf<Sensor::Temperature>() == "temperature". Returns an empty string if no device class.
+ */
+template <typename T> constexpr std::string_view deviceClassOf() {
+  return T().deviceClass().value_or(std::string_view());
+}
+
 /**
  * @brief Device classes and their units from https://www.home-assistant.io/integrations/sensor/#device-class
  */
@@ -43,14 +116,7 @@ namespace Sensor {
  */
 class Aqi : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "aqi";
+  constexpr Aqi() : DeviceClass(SensorType::Sensor, "aqi") {}
 };
 
 /**
@@ -60,39 +126,10 @@ class Area : public DeviceClass {
 public:
   enum Unit : UnitType { m2 = 1, cm2, km2, mm2, in2, ft2, yd2, mi2, ac, ha };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case m2:
-      return "m2";
-    case cm2:
-      return "cm2";
-    case km2:
-      return "km2";
-    case mm2:
-      return "mm2";
-    case in2:
-      return "in2";
-    case ft2:
-      return "ft2";
-    case yd2:
-      return "yd2";
-    case mi2:
-      return "mi2";
-    case ac:
-      return "ac";
-    case ha:
-      return "ha";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Area() : DeviceClass(SensorType::Sensor, "area", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "area";
+  static constexpr std::string_view UNITS[] = {"m2", "cm2", "km2", "mm2", "in2", "ft2", "yd2", "mi2", "ac", "ha"};
 };
 
 // Repeat this structure for other namespaces using their specific units and device classes
@@ -104,37 +141,10 @@ class AtmosphericPressure : public DeviceClass {
 public:
   enum Unit : UnitType { cbar = 1, bar, hPa, mmHg, inHg, kPa, mbar, Pa, psi };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case cbar:
-      return "cbar";
-    case bar:
-      return "bar";
-    case hPa:
-      return "hPa";
-    case mmHg:
-      return "mmHg";
-    case inHg:
-      return "inHg";
-    case kPa:
-      return "kPa";
-    case mbar:
-      return "mbar";
-    case Pa:
-      return "Pa";
-    case psi:
-      return "psi";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr AtmosphericPressure() : DeviceClass(SensorType::Sensor, "atmospheric_pressure", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "atmospheric_pressure";
+  static constexpr std::string_view UNITS[] = {"cbar", "bar", "hPa", "mmHg", "inHg", "kPa", "mbar", "Pa", "psi"};
 };
 
 /**
@@ -144,21 +154,10 @@ class Battery : public DeviceClass {
 public:
   enum Unit : UnitType { Percent = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Percent:
-      return "%";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Battery() : DeviceClass(SensorType::Sensor, "battery", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "battery";
+  static constexpr std::string_view UNITS[] = {"%"};
 };
 
 /**
@@ -168,23 +167,10 @@ class BloodGlucoseConcentration : public DeviceClass {
 public:
   enum Unit : UnitType { mg_dL = 1, mmol_L };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case mg_dL:
-      return "mg/dL";
-    case mmol_L:
-      return "mmol/L";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr BloodGlucoseConcentration() : DeviceClass(SensorType::Sensor, "blood_glucose_concentration", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "blood_glucose_concentration";
+  static constexpr std::string_view UNITS[] = {"mg/dL", "mmol/L"};
 };
 
 /**
@@ -194,21 +180,10 @@ class CarbonDioxide : public DeviceClass {
 public:
   enum Unit : UnitType { ppm = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ppm:
-      return "ppm";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr CarbonDioxide() : DeviceClass(SensorType::Sensor, "carbon_dioxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "carbon_dioxide";
+  static constexpr std::string_view UNITS[] = {"ppm"};
 };
 
 // CarbonMonoxide
@@ -216,21 +191,10 @@ class CarbonMonoxide : public DeviceClass {
 public:
   enum Unit : UnitType { ppm = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ppm:
-      return "ppm";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr CarbonMonoxide() : DeviceClass(SensorType::Sensor, "carbon_monoxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "carbon_monoxide";
+  static constexpr std::string_view UNITS[] = {"ppm"};
 };
 
 // Current
@@ -238,23 +202,10 @@ class Current : public DeviceClass {
 public:
   enum Unit : UnitType { A = 1, mA };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case A:
-      return "A";
-    case mA:
-      return "mA";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Current() : DeviceClass(SensorType::Sensor, "current", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "current";
+  static constexpr std::string_view UNITS[] = {"A", "mA"};
 };
 
 // DataRate
@@ -262,41 +213,11 @@ class DataRate : public DeviceClass {
 public:
   enum Unit : UnitType { bits = 1, kbits, Mbits, Gbits, Bps, kBps, MBps, GBps, KiBps, MiBps, GiBps };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case bits:
-      return "bit/s";
-    case kbits:
-      return "kbit/s";
-    case Mbits:
-      return "Mbit/s";
-    case Gbits:
-      return "Gbit/s";
-    case Bps:
-      return "B/s";
-    case kBps:
-      return "kB/s";
-    case MBps:
-      return "MB/s";
-    case GBps:
-      return "GB/s";
-    case KiBps:
-      return "KiB/s";
-    case MiBps:
-      return "MiB/s";
-    case GiBps:
-      return "GiB/s";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr DataRate() : DeviceClass(SensorType::Sensor, "data_rate", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "data_rate";
+  static constexpr std::string_view UNITS[] = {"bit/s", "kbit/s", "Mbit/s", "Gbit/s", "B/s", "kB/s", "MB/s", "GB/s",
+                                               "KiB/s", "MiB/s", "GiB/s"};
 };
 
 // DataSize
@@ -326,74 +247,17 @@ public:
     YiB
   };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case bits:
-      return "bit";
-    case kbits:
-      return "kbit";
-    case Mbits:
-      return "Mbit";
-    case Gbits:
-      return "Gbit";
-    case B:
-      return "B";
-    case kB:
-      return "kB";
-    case MB:
-      return "MB";
-    case GB:
-      return "GB";
-    case TB:
-      return "TB";
-    case PB:
-      return "PB";
-    case EB:
-      return "EB";
-    case ZB:
-      return "ZB";
-    case YB:
-      return "YB";
-    case KiB:
-      return "KiB";
-    case MiB:
-      return "MiB";
-    case GiB:
-      return "GiB";
-    case TiB:
-      return "TiB";
-    case PiB:
-      return "PiB";
-    case EiB:
-      return "EiB";
-    case ZiB:
-      return "ZiB";
-    case YiB:
-      return "YiB";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr DataSize() : DeviceClass(SensorType::Sensor, "data_size", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "data_size";
+  static constexpr std::string_view UNITS[] = {"bit", "kbit", "Mbit", "Gbit", "B", "kB", "MB", "GB", "TB", "PB", "EB",
+                                               "ZB", "YB", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB", "ZiB", "YiB"};
 };
 
 // Date
 class Date : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "date";
+  constexpr Date() : DeviceClass(SensorType::Sensor, "date") {}
 };
 
 // Distance
@@ -401,35 +265,10 @@ class Distance : public DeviceClass {
 public:
   enum Unit : UnitType { km = 1, m, cm, mm, mi, nmi, yd, in };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case km:
-      return "km";
-    case m:
-      return "m";
-    case cm:
-      return "cm";
-    case mm:
-      return "mm";
-    case mi:
-      return "mi";
-    case nmi:
-      return "nmi";
-    case yd:
-      return "yd";
-    case in:
-      return "in";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Distance() : DeviceClass(SensorType::Sensor, "distance", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "distance";
+  static constexpr std::string_view UNITS[] = {"km", "m", "cm", "mm", "mi", "nmi", "yd", "in"};
 };
 
 // Duration
@@ -437,29 +276,10 @@ class Duration : public DeviceClass {
 public:
   enum Unit : UnitType { d = 1, h, min, s, ms };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case d:
-      return "d";
-    case h:
-      return "h";
-    case min:
-      return "min";
-    case s:
-      return "s";
-    case ms:
-      return "ms";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Duration() : DeviceClass(SensorType::Sensor, "duration", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "duration";
+  static constexpr std::string_view UNITS[] = {"d", "h", "min", "s", "ms"};
 };
 
 // Energy
@@ -467,47 +287,11 @@ class Energy : public DeviceClass {
 public:
   enum Unit : UnitType { J = 1, kJ, MJ, GJ, mWh, Wh, kWh, MWh, GWh, TWh, cal, kcal, Mcal, Gcal };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case J:
-      return "J";
-    case kJ:
-      return "kJ";
-    case MJ:
-      return "MJ";
-    case GJ:
-      return "GJ";
-    case mWh:
-      return "mWh";
-    case Wh:
-      return "Wh";
-    case kWh:
-      return "kWh";
-    case MWh:
-      return "MWh";
-    case GWh:
-      return "GWh";
-    case TWh:
-      return "TWh";
-    case cal:
-      return "cal";
-    case kcal:
-      return "kcal";
-    case Mcal:
-      return "Mcal";
-    case Gcal:
-      return "Gcal";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Energy() : DeviceClass(SensorType::Sensor, "energy", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "energy";
+  static constexpr std::string_view UNITS[] = {"J", "kJ", "MJ", "GJ", "mWh", "Wh", "kWh", "MWh", "GWh", "TWh", "cal",
+                                               "kcal", "Mcal", "Gcal"};
 };
 
 // EnergyStorage
@@ -515,60 +299,17 @@ class EnergyStorage : public DeviceClass {
 public:
   enum Unit : UnitType { J = 1, kJ, MJ, GJ, mWh, Wh, kWh, MWh, GWh, TWh, cal, kcal, Mcal, Gcal };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case J:
-      return "J";
-    case kJ:
-      return "kJ";
-    case MJ:
-      return "MJ";
-    case GJ:
-      return "GJ";
-    case mWh:
-      return "mWh";
-    case Wh:
-      return "Wh";
-    case kWh:
-      return "kWh";
-    case MWh:
-      return "MWh";
-    case GWh:
-      return "GWh";
-    case TWh:
-      return "TWh";
-    case cal:
-      return "cal";
-    case kcal:
-      return "kcal";
-    case Mcal:
-      return "Mcal";
-    case Gcal:
-      return "Gcal";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr EnergyStorage() : DeviceClass(SensorType::Sensor, "energy_storage", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "energy_storage";
+  static constexpr std::string_view UNITS[] = {"J", "kJ", "MJ", "GJ", "mWh", "Wh", "kWh", "MWh", "GWh", "TWh", "cal",
+                                               "kcal", "Mcal", "Gcal"};
 };
 
 // Enum
 class Enum : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "enum";
+  constexpr Enum() : DeviceClass(SensorType::Sensor, "enum") {}
 };
 
 // Frequency
@@ -576,27 +317,10 @@ class Frequency : public DeviceClass {
 public:
   enum Unit : UnitType { Hz = 1, kHz, MHz, GHz };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Hz:
-      return "Hz";
-    case kHz:
-      return "kHz";
-    case MHz:
-      return "MHz";
-    case GHz:
-      return "GHz";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Frequency() : DeviceClass(SensorType::Sensor, "frequency", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "frequency";
+  static constexpr std::string_view UNITS[] = {"Hz", "kHz", "MHz", "GHz"};
 };
 
 // Gas
@@ -604,25 +328,10 @@ class Gas : public DeviceClass {
 public:
   enum Unit : UnitType { m3 = 1, ft3, CCF };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case m3:
-      return "m³";
-    case ft3:
-      return "ft³";
-    case CCF:
-      return "CCF";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Gas() : DeviceClass(SensorType::Sensor, "gas", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "gas";
+  static constexpr std::string_view UNITS[] = {"m³", "ft³", "CCF"};
 };
 
 // Humidity
@@ -630,21 +339,10 @@ class Humidity : public DeviceClass {
 public:
   enum Unit : UnitType { Percent = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Percent:
-      return "%";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Humidity() : DeviceClass(SensorType::Sensor, "humidity", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "humidity";
+  static constexpr std::string_view UNITS[] = {"%"};
 };
 
 // AbsoluteHumidity
@@ -652,23 +350,10 @@ class AbsoluteHumidity : public DeviceClass {
 public:
   enum Unit : UnitType { gm3 = 1, mgm3 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case gm3:
-      return "g/m³";
-    case mgm3:
-      return "mg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr AbsoluteHumidity() : DeviceClass(SensorType::Sensor, "absolute_humidity", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "absolute_humidity";
+  static constexpr std::string_view UNITS[] = {"g/m³", "mg/m³"};
 };
 
 // Illuminance
@@ -676,21 +361,10 @@ class Illuminance : public DeviceClass {
 public:
   enum Unit : UnitType { lx = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case lx:
-      return "lx";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Illuminance() : DeviceClass(SensorType::Sensor, "illuminance", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "illuminance";
+  static constexpr std::string_view UNITS[] = {"lx"};
 };
 
 // Irradiance
@@ -698,23 +372,10 @@ class Irradiance : public DeviceClass {
 public:
   enum Unit : UnitType { W_m2 = 1, BTU_ft2_h };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case W_m2:
-      return "W/m²";
-    case BTU_ft2_h:
-      return "BTU/(h⋅ft²)";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Irradiance() : DeviceClass(SensorType::Sensor, "irradiance", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "irradiance";
+  static constexpr std::string_view UNITS[] = {"W/m²", "BTU/(h⋅ft²)"};
 };
 
 // Moisture
@@ -722,34 +383,16 @@ class Moisture : public DeviceClass {
 public:
   enum Unit : UnitType { Percent = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Percent:
-      return "%";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Moisture() : DeviceClass(SensorType::Sensor, "moisture", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "moisture";
+  static constexpr std::string_view UNITS[] = {"%"};
 };
 
 // Monetary
 class Monetary : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "monetary";
+  constexpr Monetary() : DeviceClass(SensorType::Sensor, "monetary") {}
 };
 
 // NitrogenDioxide
@@ -757,21 +400,10 @@ class NitrogenDioxide : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr NitrogenDioxide() : DeviceClass(SensorType::Sensor, "nitrogen_dioxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "nitrogen_dioxide";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // NitrogenMonoxide
@@ -779,21 +411,10 @@ class NitrogenMonoxide : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr NitrogenMonoxide() : DeviceClass(SensorType::Sensor, "nitrogen_monoxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "nitrogen_monoxide";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // NitrousOxide
@@ -801,21 +422,10 @@ class NitrousOxide : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr NitrousOxide() : DeviceClass(SensorType::Sensor, "nitrous_oxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "nitrous_oxide";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // Ozone
@@ -823,34 +433,16 @@ class Ozone : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Ozone() : DeviceClass(SensorType::Sensor, "ozone", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "ozone";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // Ph
 class Ph : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "ph";
+  constexpr Ph() : DeviceClass(SensorType::Sensor, "ph") {}
 };
 
 // Pm1
@@ -858,21 +450,10 @@ class Pm1 : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Pm1() : DeviceClass(SensorType::Sensor, "pm1", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "pm1";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // Pm25
@@ -880,21 +461,10 @@ class Pm25 : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Pm25() : DeviceClass(SensorType::Sensor, "pm25", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "pm25";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // Pm10
@@ -902,21 +472,10 @@ class Pm10 : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Pm10() : DeviceClass(SensorType::Sensor, "pm10", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "pm10";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // PowerFactor
@@ -924,23 +483,10 @@ class PowerFactor : public DeviceClass {
 public:
   enum Unit : UnitType { None = 1, Percent };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case None:
-      return std::nullopt;
-    case Percent:
-      return "%";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr PowerFactor() : DeviceClass(SensorType::Sensor, "power_factor", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "power_factor";
+  static constexpr std::string_view UNITS[] = {{}, "%"};
 };
 
 // Power
@@ -948,31 +494,10 @@ class Power : public DeviceClass {
 public:
   enum Unit : UnitType { mW = 1, W, kW, MW, GW, TW };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case mW:
-      return "mW";
-    case W:
-      return "W";
-    case kW:
-      return "kW";
-    case MW:
-      return "MW";
-    case GW:
-      return "GW";
-    case TW:
-      return "TW";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Power() : DeviceClass(SensorType::Sensor, "power", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "power";
+  static constexpr std::string_view UNITS[] = {"mW", "W", "kW", "MW", "GW", "TW"};
 };
 
 // Precipitation
@@ -980,25 +505,10 @@ class Precipitation : public DeviceClass {
 public:
   enum Unit : UnitType { cm = 1, in, mm };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case cm:
-      return "cm";
-    case in:
-      return "in";
-    case mm:
-      return "mm";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Precipitation() : DeviceClass(SensorType::Sensor, "precipitation", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "precipitation";
+  static constexpr std::string_view UNITS[] = {"cm", "in", "mm"};
 };
 
 // PrecipitationIntensity
@@ -1006,27 +516,10 @@ class PrecipitationIntensity : public DeviceClass {
 public:
   enum Unit : UnitType { in_d = 1, in_h, mm_d, mm_h };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case in_d:
-      return "in/d";
-    case in_h:
-      return "in/h";
-    case mm_d:
-      return "mm/d";
-    case mm_h:
-      return "mm/h";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr PrecipitationIntensity() : DeviceClass(SensorType::Sensor, "precipitation_intensity", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "precipitation_intensity";
+  static constexpr std::string_view UNITS[] = {"in/d", "in/h", "mm/d", "mm/h"};
 };
 
 // Pressure
@@ -1034,37 +527,10 @@ class Pressure : public DeviceClass {
 public:
   enum Unit : UnitType { Pa = 1, kPa, hPa, bar, cbar, mbar, mmHg, inHg, psi };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Pa:
-      return "Pa";
-    case kPa:
-      return "kPa";
-    case hPa:
-      return "hPa";
-    case bar:
-      return "bar";
-    case cbar:
-      return "cbar";
-    case mbar:
-      return "mbar";
-    case mmHg:
-      return "mmHg";
-    case inHg:
-      return "inHg";
-    case psi:
-      return "psi";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Pressure() : DeviceClass(SensorType::Sensor, "pressure", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "pressure";
+  static constexpr std::string_view UNITS[] = {"Pa", "kPa", "hPa", "bar", "cbar", "mbar", "mmHg", "inHg", "psi"};
 };
 
 // ReactivePower
@@ -1072,21 +538,10 @@ class ReactivePower : public DeviceClass {
 public:
   enum Unit : UnitType { var = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case var:
-      return "var";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr ReactivePower() : DeviceClass(SensorType::Sensor, "reactive_power", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "reactive_power";
+  static constexpr std::string_view UNITS[] = {"var"};
 };
 
 // SignalStrength
@@ -1094,23 +549,10 @@ class SignalStrength : public DeviceClass {
 public:
   enum Unit : UnitType { dB = 1, dBm };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case dB:
-      return "dB";
-    case dBm:
-      return "dBm";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr SignalStrength() : DeviceClass(SensorType::Sensor, "signal_strength", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "signal_strength";
+  static constexpr std::string_view UNITS[] = {"dB", "dBm"};
 };
 
 // SoundPressure
@@ -1118,23 +560,10 @@ class SoundPressure : public DeviceClass {
 public:
   enum Unit : UnitType { dB = 1, dBA };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case dB:
-      return "dB";
-    case dBA:
-      return "dBA";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr SoundPressure() : DeviceClass(SensorType::Sensor, "sound_pressure", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "sound_pressure";
+  static constexpr std::string_view UNITS[] = {"dB", "dBA"};
 };
 
 // Speed
@@ -1142,39 +571,11 @@ class Speed : public DeviceClass {
 public:
   enum Unit : UnitType { ft_s = 1, in_d, in_h, in_s, km_h, kn, m_s, mph, mm_d, mm_s };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ft_s:
-      return "ft/s";
-    case in_d:
-      return "in/d";
-    case in_h:
-      return "in/h";
-    case in_s:
-      return "in/s";
-    case km_h:
-      return "km/h";
-    case kn:
-      return "kn";
-    case m_s:
-      return "m/s";
-    case mph:
-      return "mph";
-    case mm_d:
-      return "mm/d";
-    case mm_s:
-      return "mm/s";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Speed() : DeviceClass(SensorType::Sensor, "speed", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "speed";
+  static constexpr std::string_view UNITS[] = {"ft/s", "in/d", "in/h", "in/s", "km/h", "kn", "m/s", "mph", "mm/d",
+                                               "mm/s"};
 };
 
 // SulphurDioxide
@@ -1182,21 +583,10 @@ class SulphurDioxide : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr SulphurDioxide() : DeviceClass(SensorType::Sensor, "sulphur_dioxide", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "sulphur_dioxide";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // Temperature
@@ -1204,38 +594,16 @@ class Temperature : public DeviceClass {
 public:
   enum Unit : UnitType { C = 1, F, K };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case C:
-      return "°C";
-    case F:
-      return "°F";
-    case K:
-      return "K";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Temperature() : DeviceClass(SensorType::Sensor, "temperature", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "temperature";
+  static constexpr std::string_view UNITS[] = {"°C", "°F", "K"};
 };
 
 // Timestamp
 class Timestamp : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "timestamp";
+  constexpr Timestamp() : DeviceClass(SensorType::Sensor, "timestamp") {}
 };
 
 // VolatileOrganicCompounds
@@ -1243,21 +611,10 @@ class VolatileOrganicCompounds : public DeviceClass {
 public:
   enum Unit : UnitType { ug_m3 = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ug_m3:
-      return "µg/m³";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr VolatileOrganicCompounds() : DeviceClass(SensorType::Sensor, "volatile_organic_compounds", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "volatile_organic_compounds";
+  static constexpr std::string_view UNITS[] = {"µg/m³"};
 };
 
 // VolatileOrganicCompoundsParts
@@ -1265,23 +622,11 @@ class VolatileOrganicCompoundsParts : public DeviceClass {
 public:
   enum Unit : UnitType { ppm = 1, ppb };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case ppm:
-      return "ppm";
-    case ppb:
-      return "ppb";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr VolatileOrganicCompoundsParts()
+      : DeviceClass(SensorType::Sensor, "volatile_organic_compounds_parts", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "volatile_organic_compounds_parts";
+  static constexpr std::string_view UNITS[] = {"ppm", "ppb"};
 };
 
 // Voltage
@@ -1289,25 +634,10 @@ class Voltage : public DeviceClass {
 public:
   enum Unit : UnitType { V = 1, mV, uV };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case V:
-      return "V";
-    case mV:
-      return "mV";
-    case uV:
-      return "µV";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Voltage() : DeviceClass(SensorType::Sensor, "voltage", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "voltage";
+  static constexpr std::string_view UNITS[] = {"V", "mV", "µV"};
 };
 
 // Volume
@@ -1315,33 +645,10 @@ class Volume : public DeviceClass {
 public:
   enum Unit : UnitType { L = 1, mL, gal, fl_oz, m3, ft3, CCF };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case L:
-      return "L";
-    case mL:
-      return "mL";
-    case gal:
-      return "gal";
-    case fl_oz:
-      return "fl. oz.";
-    case m3:
-      return "m³";
-    case ft3:
-      return "ft³";
-    case CCF:
-      return "CCF";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Volume() : DeviceClass(SensorType::Sensor, "volume", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "volume";
+  static constexpr std::string_view UNITS[] = {"L", "mL", "gal", "fl. oz.", "m³", "ft³", "CCF"};
 };
 
 // VolumeFlowRate
@@ -1349,29 +656,10 @@ class VolumeFlowRate : public DeviceClass {
 public:
   enum Unit : UnitType { m3_h = 1, ft3_min, L_min, gal_min, mL_s };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case m3_h:
-      return "m³/h";
-    case ft3_min:
-      return "ft³/min";
-    case L_min:
-      return "L/min";
-    case gal_min:
-      return "gal/min";
-    case mL_s:
-      return "mL/s";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr VolumeFlowRate() : DeviceClass(SensorType::Sensor, "volume_flow_rate", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "volume_flow_rate";
+  static constexpr std::string_view UNITS[] = {"m³/h", "ft³/min", "L/min", "gal/min", "mL/s"};
 };
 
 // VolumeStorage
@@ -1379,33 +667,10 @@ class VolumeStorage : public DeviceClass {
 public:
   enum Unit : UnitType { L = 1, mL, gal, fl_oz, m3, ft3, CCF };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case L:
-      return "L";
-    case mL:
-      return "mL";
-    case gal:
-      return "gal";
-    case fl_oz:
-      return "fl. oz.";
-    case m3:
-      return "m³";
-    case ft3:
-      return "ft³";
-    case CCF:
-      return "CCF";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr VolumeStorage() : DeviceClass(SensorType::Sensor, "volume_storage", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "volume_storage";
+  static constexpr std::string_view UNITS[] = {"L", "mL", "gal", "fl. oz.", "m³", "ft³", "CCF"};
 };
 
 // Water
@@ -1413,29 +678,10 @@ class Water : public DeviceClass {
 public:
   enum Unit : UnitType { L = 1, gal, m3, ft3, CCF };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case L:
-      return "L";
-    case gal:
-      return "gal";
-    case m3:
-      return "m³";
-    case ft3:
-      return "ft³";
-    case CCF:
-      return "CCF";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Water() : DeviceClass(SensorType::Sensor, "water", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "water";
+  static constexpr std::string_view UNITS[] = {"L", "gal", "m³", "ft³", "CCF"};
 };
 
 // Weight
@@ -1443,33 +689,10 @@ class Weight : public DeviceClass {
 public:
   enum Unit : UnitType { kg = 1, g, mg, ug, oz, lb, st };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case kg:
-      return "kg";
-    case g:
-      return "g";
-    case mg:
-      return "mg";
-    case ug:
-      return "µg";
-    case oz:
-      return "oz";
-    case lb:
-      return "lb";
-    case st:
-      return "st";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr Weight() : DeviceClass(SensorType::Sensor, "weight", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "weight";
+  static constexpr std::string_view UNITS[] = {"kg", "g", "mg", "µg", "oz", "lb", "st"};
 };
 
 // WindSpeed
@@ -1477,31 +700,10 @@ class WindSpeed : public DeviceClass {
 public:
   enum Unit : UnitType { Beaufort = 1, ft_s, km_h, kn, m_s, mph };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Beaufort:
-      return "Beaufort";
-    case ft_s:
-      return "ft/s";
-    case km_h:
-      return "km/h";
-    case kn:
-      return "kn";
-    case m_s:
-      return "m/s";
-    case mph:
-      return "mph";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr WindSpeed() : DeviceClass(SensorType::Sensor, "wind_speed", UNITS) {}
 
 private:
-  static constexpr const char *DEVICE_CLASS = "wind_speed";
+  static constexpr std::string_view UNITS[] = {"Beaufort", "ft/s", "km/h", "kn", "m/s", "mph"};
 };
 
 /**
@@ -1512,31 +714,18 @@ namespace Undefined {
 
 class Empty : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
+  constexpr Empty() : DeviceClass(SensorType::Sensor, {}) {}
 };
 
 class Brightness : public DeviceClass {
 public:
   enum Unit : UnitType { Percent = 1 };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return std::nullopt; } // No brightness device class exists.
+  // No brightness device class exists.
+  constexpr Brightness() : DeviceClass(SensorType::Sensor, {}, UNITS, "brightness") {}
 
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case Percent:
-      return "%";
-    default:
-      return std::nullopt;
-    }
-  }
-
-  std::string objectId() const override { return "brightness"; }
+private:
+  static constexpr std::string_view UNITS[] = {"%"};
 };
 
 /**
@@ -1546,47 +735,34 @@ class UnitConcentration : public DeviceClass {
 public:
   enum Unit : UnitType { mL = 1, dL, L };
 
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
   // No unit concentration device class exists.
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override {
-    switch (unit) {
-    case mL:
-      return "/mL";
-    case dL:
-      return "/dL";
-    case L:
-      return "/L";
-    default:
-      return std::nullopt;
-    }
-  }
+  constexpr UnitConcentration() : DeviceClass(SensorType::Sensor, {}, UNITS, "unit_concentration") {}
 
-  std::string objectId() const override { return "unit_concentration"; }
+private:
+  static constexpr std::string_view UNITS[] = {"/mL", "/dL", "/L"};
 };
 
-class Json : public DeviceClass {
+/**
+ * @brief Counters and rates reported by the library itself, see HaEntityDiagnostics.
+ */
+class Diagnostic : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
+  enum Unit : UnitType { Messages = 1, MessagesPerMinute };
 
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
+  constexpr Diagnostic() : DeviceClass(SensorType::Sensor, {}, UNITS, "diagnostic") {}
 
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
+private:
+  static constexpr std::string_view UNITS[] = {"msg", "msg/min"};
+};
 
-  std::string objectId() const override { return "json"; }
+class Json : public DeviceClass {
+public:
+  constexpr Json() : DeviceClass(SensorType::Sensor, {}, "json") {}
 };
 
 class String : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::Sensor; }
-
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-  std::string objectId() const override { return "string"; }
+  constexpr String() : DeviceClass(SensorType::Sensor, {}, "string") {}
 };
 
 }; // namespace Undefined
@@ -1603,14 +779,7 @@ namespace BinarySensor {
  */
 class Battery : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "battery";
+  constexpr Battery() : DeviceClass(SensorType::BinarySensor, "battery") {}
 };
 
 /**
@@ -1618,14 +787,7 @@ private:
  */
 class BatteryCharging : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "battery_charging";
+  constexpr BatteryCharging() : DeviceClass(SensorType::BinarySensor, "battery_charging") {}
 };
 
 /**
@@ -1633,14 +795,7 @@ private:
  */
 class CarbonMonoxide : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "carbon_monoxide";
+  constexpr CarbonMonoxide() : DeviceClass(SensorType::BinarySensor, "carbon_monoxide") {}
 };
 
 /**
@@ -1648,14 +803,7 @@ private:
  */
 class Cold : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "cold";
+  constexpr Cold() : DeviceClass(SensorType::BinarySensor, "cold") {}
 };
 
 /**
@@ -1663,14 +811,7 @@ private:
  */
 class Connectivity : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "connectivity";
+  constexpr Connectivity() : DeviceClass(SensorType::BinarySensor, "connectivity") {}
 };
 
 /**
@@ -1678,14 +819,7 @@ private:
  */
 class Door : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "door";
+  constexpr Door() : DeviceClass(SensorType::BinarySensor, "door") {}
 };
 
 /**
@@ -1693,14 +827,7 @@ private:
  */
 class GarageDoor : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "garage_door";
+  constexpr GarageDoor() : DeviceClass(SensorType::BinarySensor, "garage_door") {}
 };
 
 /**
@@ -1708,14 +835,7 @@ private:
  */
 class Gas : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "gas";
+  constexpr Gas() : DeviceClass(SensorType::BinarySensor, "gas") {}
 };
 
 /**
@@ -1723,14 +843,7 @@ private:
  */
 class Heat : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "heat";
+  constexpr Heat() : DeviceClass(SensorType::BinarySensor, "heat") {}
 };
 
 /**
@@ -1738,14 +851,7 @@ private:
  */
 class Light : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "light";
+  constexpr Light() : DeviceClass(SensorType::BinarySensor, "light") {}
 };
 
 /**
@@ -1753,14 +859,7 @@ private:
  */
 class Lock : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "lock";
+  constexpr Lock() : DeviceClass(SensorType::BinarySensor, "lock") {}
 };
 
 /**
@@ -1768,14 +867,7 @@ private:
  */
 class Moisture : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "moisture";
+  constexpr Moisture() : DeviceClass(SensorType::BinarySensor, "moisture") {}
 };
 
 /**
@@ -1783,14 +875,7 @@ private:
  */
 class Motion : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "motion";
+  constexpr Motion() : DeviceClass(SensorType::BinarySensor, "motion") {}
 };
 
 /**
@@ -1798,14 +883,7 @@ private:
  */
 class Moving : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "moving";
+  constexpr Moving() : DeviceClass(SensorType::BinarySensor, "moving") {}
 };
 
 /**
@@ -1813,14 +891,7 @@ private:
  */
 class Occupancy : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "occupancy";
+  constexpr Occupancy() : DeviceClass(SensorType::BinarySensor, "occupancy") {}
 };
 
 /**
@@ -1828,14 +899,7 @@ private:
  */
 class Opening : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "opening";
+  constexpr Opening() : DeviceClass(SensorType::BinarySensor, "opening") {}
 };
 
 /**
@@ -1843,14 +907,7 @@ private:
  */
 class Plug : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "plug";
+  constexpr Plug() : DeviceClass(SensorType::BinarySensor, "plug") {}
 };
 
 /**
@@ -1858,14 +915,7 @@ private:
  */
 class Power : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "power";
+  constexpr Power() : DeviceClass(SensorType::BinarySensor, "power") {}
 };
 
 /**
@@ -1873,14 +923,7 @@ private:
  */
 class Presence : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "presence";
+  constexpr Presence() : DeviceClass(SensorType::BinarySensor, "presence") {}
 };
 
 /**
@@ -1888,14 +931,7 @@ private:
  */
 class Problem : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "problem";
+  constexpr Problem() : DeviceClass(SensorType::BinarySensor, "problem") {}
 };
 
 /**
@@ -1903,14 +939,7 @@ private:
  */
 class Running : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "running";
+  constexpr Running() : DeviceClass(SensorType::BinarySensor, "running") {}
 };
 
 /**
@@ -1918,14 +947,7 @@ private:
  */
 class Safety : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "safety";
+  constexpr Safety() : DeviceClass(SensorType::BinarySensor, "safety") {}
 };
 
 /**
@@ -1933,14 +955,7 @@ private:
  */
 class Smoke : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "smoke";
+  constexpr Smoke() : DeviceClass(SensorType::BinarySensor, "smoke") {}
 };
 
 /**
@@ -1948,14 +963,7 @@ private:
  */
 class Sound : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "sound";
+  constexpr Sound() : DeviceClass(SensorType::BinarySensor, "sound") {}
 };
 
 /**
@@ -1963,14 +971,7 @@ private:
  */
 class Tamper : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "tamper";
+  constexpr Tamper() : DeviceClass(SensorType::BinarySensor, "tamper") {}
 };
 
 /**
@@ -1978,14 +979,7 @@ private:
  */
 class Update : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "update";
+  constexpr Update() : DeviceClass(SensorType::BinarySensor, "update") {}
 };
 
 /**
@@ -1993,14 +987,7 @@ private:
  */
 class Vibration : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "vibration";
+  constexpr Vibration() : DeviceClass(SensorType::BinarySensor, "vibration") {}
 };
 
 /**
@@ -2008,14 +995,7 @@ private:
  */
 class Window : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return DEVICE_CLASS; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-private:
-  static constexpr const char *DEVICE_CLASS = "window";
+  constexpr Window() : DeviceClass(SensorType::BinarySensor, "window") {}
 };
 
 /**
@@ -2026,22 +1006,12 @@ namespace Undefined {
 
 class Empty : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
+  constexpr Empty() : DeviceClass(SensorType::BinarySensor, {}) {}
 };
 
 class Boolean : public DeviceClass {
 public:
-  SensorType sensorType() const override { return SensorType::BinarySensor; }
-
-  std::optional<std::string> deviceClass() const override { return std::nullopt; }
-
-  std::optional<std::string> unitOfMeasurement(UnitType unit) const override { return std::nullopt; }
-
-  std::string objectId() const override { return "boolean"; }
+  constexpr Boolean() : DeviceClass(SensorType::BinarySensor, {}, "boolean") {}
 };
 
 }; // namespace Undefined
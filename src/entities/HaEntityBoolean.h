@@ -27,9 +27,15 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = Configuration{.with_attributes = false, .force_update = false};
+  inline static Configuration _default =
+      Configuration{.with_attributes = false, .force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity Boolean object
@@ -58,11 +64,15 @@ public:
                                              .state_class = std::nullopt,
                                              .with_attributes = configuration.with_attributes,
                                              .force_update = configuration.force_update,
+                                             .expire_after = configuration.expire_after,
                                          })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the boolean value for the binary sensor. This will publish to MQTT regardless if the value has
@@ -72,7 +82,7 @@ public:
    * @param attributes optional attributes to send with the value. with_attributes in constructor must be set.
    */
   void publishBoolean(bool value, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.publishValue(value ? "ON" : "OFF", attributes);
+    _ha_entity_sensor.publishValue(value ? "ON" : "OFF", std::move(attributes));
   }
 
   /**
@@ -83,7 +93,7 @@ public:
    * @param attributes optional attributes to send with the value. with_attributes in constructor must be set.
    */
   void updateBoolean(bool value, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.updateValue(value ? "ON" : "OFF", attributes);
+    _ha_entity_sensor.updateValue(value ? "ON" : "OFF", std::move(attributes));
   }
 
   /**
@@ -92,7 +102,7 @@ public:
    *
    * @param attributes attributes to publish.
    */
-  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(attributes); }
+  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(std::move(attributes)); }
 
   /**
    * @brief Publish attributes only, but only if the value has changed. Also see
@@ -100,10 +110,10 @@ public:
    *
    * @param attributes attributes to publish.
    */
-  void updateAttributes(Attributes::Map attributes) { _ha_entity_sensor.updateAttributes(attributes); }
+  void updateAttributes(Attributes::Map attributes) { _ha_entity_sensor.updateAttributes(std::move(attributes)); }
 
 private:
-  const homeassistantentities::BinarySensor::Undefined::Boolean _boolean;
+  static constexpr homeassistantentities::BinarySensor::Undefined::Boolean _boolean = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
@@ -20,9 +20,14 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = Configuration{.force_update = false};
+  inline static Configuration _default = Configuration{.force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity Brightness object
@@ -52,11 +57,15 @@ public:
                 .unit_of_measurement = homeassistantentities::Sensor::Undefined::Brightness::Unit::Percent,
                 .icon = "mdi:brightness-percent",
                 .force_update = configuration.force_update,
+                .expire_after = configuration.expire_after,
             })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the brightness. This will publish to MQTT regardless if the value has changed.
@@ -78,7 +87,7 @@ private:
   std::string stateTopic();
 
 private:
-  const homeassistantentities::Sensor::Undefined::Brightness _brightness;
+  static constexpr homeassistantentities::Sensor::Undefined::Brightness _brightness = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
@@ -10,13 +10,13 @@
 // NOTE! We have swapped object ID and child object ID to get a nicer state/command topic path.
 
 HaEntityButton::HaEntityButton(HaBridge &ha_bridge, std::string name, std::string child_object_id)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id) {}
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id) {}
 
 void HaEntityButton::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -30,11 +30,12 @@ void HaEntityButton::publishConfiguration() {
 void HaEntityButton::republishState() {}
 
 bool HaEntityButton::setOnPressed(std::function<void(void)> callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_COMMAND),
       [callback](std::string topic, std::string message) {
         if (message == PAYLOAD_PRESS) {
           callback();
         }
-      });
+      },
+      false); // Every press counts, do not coalesce.
 }
@@ -3,6 +3,7 @@
 
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -44,9 +45,9 @@ public:
   bool setOnPressed(std::function<void(void)> callback);
 
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
+  homeassistantentities::InternedString _child_object_id;
 };
 
 #endif // __HA_ENTITY_BUTTON_H__
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "HaEntityCover.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 #include <algorithm>
@@ -11,16 +12,34 @@
 
 using namespace homeassistantentities;
 
+static std::string_view stateToPayload(HaEntityCover::State state) {
+  switch (state) {
+  case HaEntityCover::State::Open:
+    return "open";
+  case HaEntityCover::State::Opening:
+    return "opening";
+  case HaEntityCover::State::Closed:
+    return "closed";
+  case HaEntityCover::State::Closing:
+    return "closing";
+  case HaEntityCover::State::Stopped:
+    return "stopped";
+  case HaEntityCover::State::Unknown:
+    break;
+  }
+  return {};
+}
+
 HaEntityCover::HaEntityCover(HaBridge &ha_bridge, std::string name, std::string child_object_id,
                              Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
       _configuration(configuration) {}
 
 void HaEntityCover::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -50,7 +69,70 @@ void HaEntityCover::publishConfiguration() {
   _ha_bridge.publishConfiguration(COMPONENT, OBJECT_ID, _child_object_id, doc);
 }
 
-void HaEntityCover::republishState() { publish(_state, _position); }
+void HaEntityCover::republishState() {
+  _ha_bridge.republishState(_lock, stateTopic(), [this]() -> std::optional<std::string_view> {
+    if (!_state || stateToPayload(*_state).empty()) {
+      return std::nullopt;
+    }
+    return stateToPayload(*_state);
+  });
+  _ha_bridge.republishState(
+      _lock, _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_POSITION),
+      [this]() { return _position ? std::optional(positionToPayload(*_position)) : std::nullopt; });
+}
+
+void HaEntityCover::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_STATE),
+      [this](const std::string &message) {
+        for (auto state : {State::Open, State::Opening, State::Closed, State::Closing, State::Stopped}) {
+          if (message == stateToPayload(state)) {
+            storeIfEmptyLocked(_lock, _state, state);
+            return;
+          }
+        }
+      });
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_POSITION),
+      [this](const std::string &message) {
+        char *end;
+        auto position = std::strtoul(message.c_str(), &end, 10);
+        if (end != message.c_str() && *end == '\0' && position <= UINT8_MAX) {
+          storeIfEmptyLocked(_lock, _position, static_cast<uint8_t>(position));
+        }
+      });
+}
+
+void HaEntityCover::saveState(std::string &record) {
+  std::optional<uint8_t> state;
+  std::optional<uint8_t> position;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    if (_state) {
+      state = static_cast<uint8_t>(*_state);
+    }
+    position = _position;
+  }
+  StateRecordWriter writer(record);
+  writer.put(state);
+  writer.put(position);
+}
+
+bool HaEntityCover::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<uint8_t> state;
+  std::optional<uint8_t> position;
+  reader.get(state);
+  reader.get(position);
+  if (!reader.ok() || (state && *state > static_cast<uint8_t>(State::Stopped))) {
+    return false;
+  }
+  if (state) {
+    storeIfEmptyLocked(_lock, _state, static_cast<State>(*state));
+  }
+  if (position) {
+    storeIfEmptyLocked(_lock, _position, *position);
+  }
+  return true;
+}
 
 void HaEntityCover::publish(std::optional<State> state, std::optional<uint8_t> position) {
   publishState(state);
@@ -59,59 +141,51 @@ void HaEntityCover::publish(std::optional<State> state, std::optional<uint8_t> p
 
 void HaEntityCover::publishState(std::optional<State> state) {
   if (state) {
-    std::string str = "";
-    switch (*state) {
-    case State::Open:
-      str = "open";
-      break;
-    case State::Opening:
-      str = "opening";
-      break;
-    case State::Closed:
-      str = "closed";
-      break;
-    case State::Closing:
-      str = "closing";
-      break;
-    case State::Stopped:
-      str = "stopped";
-      break;
-    case State::Unknown:
-      break;
-    }
-    if (str.length() > 0) {
-      _ha_bridge.publishMessage(
-          _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_STATE), str);
-      _state = state;
+    auto payload = stateToPayload(*state);
+    if (!payload.empty()) {
+      _ha_bridge.publishState(_lock, stateTopic(), payload, [&]() { _state = state; });
     }
   }
 }
 
 void HaEntityCover::publishPosition(std::optional<uint8_t> position) {
   if (position) {
-    uint8_t lo = _configuration.position_closed;
-    uint8_t hi = _configuration.position_open;
-    if (lo > hi) {
-      std::swap(lo, hi);
-    }
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_POSITION),
-        std::to_string(std::clamp(*position, lo, hi)));
-    _position = position;
+    _ha_bridge.publishState(
+        _lock, _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_POSITION),
+        positionToPayload(*position), [&]() { _position = position; });
+  }
+}
+
+std::string HaEntityCover::positionToPayload(uint8_t position) const {
+  uint8_t lo = _configuration.position_closed;
+  uint8_t hi = _configuration.position_open;
+  if (lo > hi) {
+    std::swap(lo, hi);
   }
+  return std::to_string(std::clamp(position, lo, hi));
+}
+
+const std::string &HaEntityCover::stateTopic() {
+  return _state_topic.get(_lock, [this]() {
+    return _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_STATE);
+  });
 }
 
 void HaEntityCover::update(std::optional<State> state, std::optional<uint8_t> position) {
-  if (state != _state) {
+  if (state != loadLocked(_lock, _state)) {
     publishState(state);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Cover);
   }
-  if (position != _position) {
+  if (position != loadLocked(_lock, _position)) {
     publishPosition(position);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Cover);
   }
 }
 
 bool HaEntityCover::setOnState(std::function<void(Action)> state_callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_STATE),
       [state_callback](std::string topic, std::string message) {
         Action state = Action::Unknown;
@@ -128,7 +202,7 @@ bool HaEntityCover::setOnState(std::function<void(Action)> state_callback) {
 }
 
 bool HaEntityCover::setOnPosition(std::function<void(uint8_t)> position_callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_POSITION),
       [position_callback](std::string topic, std::string message) {
         char *end;
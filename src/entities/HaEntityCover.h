@@ -2,7 +2,10 @@
 #define __HA_ENTITY_COVER_H__
 
 #include <HaBridge.h>
+#include <HaCachedTopic.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -79,6 +82,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   enum class State {
     Open,
@@ -131,16 +137,20 @@ public:
 private:
   void publishState(std::optional<State> state);
   void publishPosition(std::optional<uint8_t> position);
+  std::string positionToPayload(uint8_t position) const;
+  const std::string &stateTopic();
 
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
+  homeassistantentities::InternedString _child_object_id;
   Configuration _configuration;
 
 private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
   std::optional<State> _state;
   std::optional<uint8_t> _position;
+  homeassistantentities::CachedTopic _state_topic;
 };
 
 #endif // __HA_ENTITY_COVER_H__
\ No newline at end of file
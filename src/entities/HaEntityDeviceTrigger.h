@@ -3,6 +3,7 @@
 
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaStringPool.h>
 #include <string>
 
 /**
@@ -56,7 +57,7 @@ public:
 
 private:
   HaBridge &_ha_bridge;
-  std::string _object_id;
+  homeassistantentities::InternedString _object_id;
   Configuration _configuration;
 };
 
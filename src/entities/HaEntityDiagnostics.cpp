@@ -0,0 +1,106 @@
+#include "HaEntityDiagnostics.h"
+#include <HaUtilities.h>
+
+#if __has_include(<esp_system.h>)
+#include <esp_system.h>
+#define HAS_FREE_HEAP
+static uint32_t freeHeap() { return esp_get_free_heap_size(); }
+#elif defined(ARDUINO_ARCH_ESP8266)
+#include <Esp.h>
+#define HAS_FREE_HEAP
+static uint32_t freeHeap() { return ESP.getFreeHeap(); }
+#endif
+
+#define ENTITY_CATEGORY "diagnostic"
+#define STATE_CLASS_MEASUREMENT "measurement"
+#define STATE_CLASS_TOTAL_INCREASING "total_increasing"
+
+using namespace homeassistantentities;
+
+HaEntityDiagnostics::HaEntityDiagnostics(HaBridge &ha_bridge, std::optional<std::string> child_object_id,
+                                         Configuration configuration)
+    : _ha_bridge(ha_bridge), _configuration(configuration),
+      _publish_rate(sensor(child_object_id, "Publish rate", "publish_rate", _diagnostic,
+                           Sensor::Undefined::Diagnostic::Unit::MessagesPerMinute, STATE_CLASS_MEASUREMENT)),
+      _failed_publishes(sensor(child_object_id, "Failed publishes", "failed_publishes", _diagnostic,
+                               Sensor::Undefined::Diagnostic::Unit::Messages, STATE_CLASS_TOTAL_INCREASING)),
+      _suppressed_duplicates(sensor(child_object_id, "Suppressed duplicates", "suppressed_duplicates", _diagnostic,
+                                    Sensor::Undefined::Diagnostic::Unit::Messages, STATE_CLASS_TOTAL_INCREASING)),
+      _queue_depth(sensor(child_object_id, "Queue depth", "queue_depth", _diagnostic,
+                          Sensor::Undefined::Diagnostic::Unit::Messages, STATE_CLASS_MEASUREMENT)),
+      _largest_message(sensor(child_object_id, "Largest message", "largest_message", _data_size,
+                              Sensor::DataSize::Unit::B, STATE_CLASS_MEASUREMENT)),
+      _discovery_duration(sensor(child_object_id, "Discovery duration", "discovery_duration", _duration,
+                                 Sensor::Duration::Unit::ms, STATE_CLASS_MEASUREMENT)),
+      _free_heap(sensor(child_object_id, "Free heap", "free_heap", _data_size, Sensor::DataSize::Unit::B,
+                        STATE_CLASS_MEASUREMENT)) {}
+
+HaEntitySensor HaEntityDiagnostics::sensor(const std::optional<std::string> &child_object_id, std::string name,
+                                           std::string diagnostic_object_id, const DeviceClass &device_class,
+                                           UnitType unit, std::string state_class) {
+  auto coid = child_object_id ? trim(*child_object_id) : "";
+  return HaEntitySensor(_ha_bridge, name, coid.empty() ? diagnostic_object_id : coid + "_" + diagnostic_object_id,
+                        HaEntitySensor::Configuration{
+                            .device_class = device_class,
+                            .unit_of_measurement = unit,
+                            .state_class = state_class,
+                            .entity_category = ENTITY_CATEGORY,
+                        });
+}
+
+void HaEntityDiagnostics::publishConfiguration() {
+  _publish_rate.publishConfiguration();
+  _failed_publishes.publishConfiguration();
+  _suppressed_duplicates.publishConfiguration();
+  _queue_depth.publishConfiguration();
+  _largest_message.publishConfiguration();
+  _discovery_duration.publishConfiguration();
+#ifdef HAS_FREE_HEAP
+  _free_heap.publishConfiguration();
+#endif
+}
+
+void HaEntityDiagnostics::republishState() {
+  _publish_rate.republishState();
+  _failed_publishes.republishState();
+  _suppressed_duplicates.republishState();
+  _queue_depth.republishState();
+  _largest_message.republishState();
+  _discovery_duration.republishState();
+#ifdef HAS_FREE_HEAP
+  _free_heap.republishState();
+#endif
+}
+
+void HaEntityDiagnostics::loop() {
+  auto now = std::chrono::steady_clock::now();
+  if (!_last_update || now - *_last_update >= std::chrono::milliseconds(_configuration.update_interval_ms)) {
+    publishDiagnostics();
+  }
+}
+
+void HaEntityDiagnostics::publishDiagnostics() {
+  auto now = std::chrono::steady_clock::now();
+  auto &metrics = _ha_bridge.metrics();
+  auto total = metrics.total();
+
+  if (_last_update) {
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - *_last_update).count();
+    if (elapsed_ms > 0) {
+      // Unsigned subtraction handles wrap around of the counter.
+      uint32_t messages = total.messages - _last_messages;
+      _publish_rate.publishValue(std::to_string(static_cast<uint64_t>(messages) * 60000 / elapsed_ms));
+    }
+  }
+  _last_update = now;
+  _last_messages = total.messages;
+
+  _failed_publishes.publishValue(std::to_string(total.failures));
+  _suppressed_duplicates.publishValue(std::to_string(total.deduplicated));
+  _queue_depth.publishValue(std::to_string(metrics.queueDepth()));
+  _largest_message.publishValue(std::to_string(metrics.maxMessageBytes()));
+  _discovery_duration.publishValue(std::to_string(metrics.discoveryDurationUs() / 1000));
+#ifdef HAS_FREE_HEAP
+  _free_heap.publishValue(std::to_string(freeHeap()));
+#endif
+}
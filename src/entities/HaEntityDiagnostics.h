@@ -0,0 +1,87 @@
+#ifndef __HA_ENTITY_DIAGNOSTICS_H__
+#define __HA_ENTITY_DIAGNOSTICS_H__
+
+#include "HaDeviceClasses.h"
+#include "HaEntitySensor.h"
+#include <HaBridge.h>
+#include <HaEntity.h>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * @brief A bundle of diagnostic sensors (entity_category "diagnostic") reporting the health of this library on this
+ * node, using the HaBridgeMetrics from HaBridge::metrics():
+ * - publish rate, in messages per minute.
+ * - failed publishes, total.
+ * - suppressed duplicates (updateX() calls that did not publish), total.
+ * - queue depth, see HaBridgeMetrics::setQueueDepth().
+ * - largest message published, in bytes.
+ * - time spent publishing discovery configurations, in ms.
+ * - free heap, in bytes (ESP32 and ESP8266 only).
+ *
+ * Call loop() regularly, the values are published at most once every update_interval_ms.
+ */
+class HaEntityDiagnostics : public HaEntity {
+public:
+  struct Configuration {
+    /**
+     * @brief How often to publish the diagnostics from loop(), in milliseconds.
+     */
+    uint32_t update_interval_ms = 60000;
+  };
+
+  inline static Configuration _default = {.update_interval_ms = 60000};
+
+  /**
+   * @brief Construct a new Ha Entity Diagnostics object
+   *
+   * @param child_object_id optional child identifier in case there are several HaEntityDiagnostics for the same node
+   * ID (only needed if using several HaBridge with the same node ID). Valid characters are [a-zA-Z0-9_-] (machine
+   * readable, not human readable)
+   * @param configuration the configuration for this entity.
+   */
+  HaEntityDiagnostics(HaBridge &ha_bridge, std::optional<std::string> child_object_id = std::nullopt,
+                      Configuration configuration = _default);
+
+public:
+  void publishConfiguration() override;
+  void republishState() override;
+
+  /**
+   * @brief Call regularly, e.g. from the Arduino loop() or a task. Publishes the diagnostics if update_interval_ms
+   * has passed since the last time.
+   */
+  void loop();
+
+  /**
+   * @brief Publish the diagnostics now, regardless of the update interval.
+   */
+  void publishDiagnostics();
+
+private:
+  HaEntitySensor sensor(const std::optional<std::string> &child_object_id, std::string name,
+                        std::string diagnostic_object_id, const homeassistantentities::DeviceClass &device_class,
+                        homeassistantentities::UnitType unit, std::string state_class);
+
+private:
+  HaBridge &_ha_bridge;
+  Configuration _configuration;
+  static constexpr homeassistantentities::Sensor::Undefined::Diagnostic _diagnostic = {};
+  static constexpr homeassistantentities::Sensor::DataSize _data_size = {};
+  static constexpr homeassistantentities::Sensor::Duration _duration = {};
+  HaEntitySensor _publish_rate;
+  HaEntitySensor _failed_publishes;
+  HaEntitySensor _suppressed_duplicates;
+  HaEntitySensor _queue_depth;
+  HaEntitySensor _largest_message;
+  HaEntitySensor _discovery_duration;
+  HaEntitySensor _free_heap;
+
+private:
+  std::optional<std::chrono::steady_clock::time_point> _last_update;
+  uint32_t _last_messages = 0;
+};
+
+#endif // __HA_ENTITY_DIAGNOSTICS_H__
@@ -42,6 +42,9 @@ public:
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the door. This will publish to MQTT regardless if the value has changed. Also see
@@ -59,7 +62,7 @@ public:
   void updateDoor(bool open) { _ha_entity_sensor.updateValue(open ? "ON" : "OFF"); }
 
 private:
-  const homeassistantentities::BinarySensor::Door _door;
+  static constexpr homeassistantentities::BinarySensor::Door _door = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
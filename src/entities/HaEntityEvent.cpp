@@ -1,18 +1,26 @@
 #include "HaEntityEvent.h"
 #include <HaUtilities.h>
 #include <IJson.h>
+#include <mutex>
 
 #define COMPONENT "event"
+#define ATTRIBUTE_COUNT "count"
+
+using namespace homeassistantentities;
 
 HaEntityEvent::HaEntityEvent(HaBridge &ha_bridge, std::string name, std::string object_id, Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _object_id(object_id),
-      _configuration(configuration) {}
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _object_id(object_id),
+      _configuration(configuration) {
+  if (_configuration.aggregation_window_ms > 0 || _configuration.max_events_per_second > 0) {
+    _aggregation = std::make_unique<Aggregation>();
+  }
+}
 
 void HaEntityEvent::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -45,11 +53,98 @@ void HaEntityEvent::republishState() {
 }
 
 void HaEntityEvent::publishEvent(std::string event, Attributes::Map attributes) {
+  if (!aggregates()) {
+    publishNow(event, attributes, 0);
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<OutgoingEvent> outgoing;
+  {
+    std::lock_guard<SpinLock> guard(_aggregation->lock);
+    collectExpired(now, outgoing);
+
+    auto pending = _aggregation->pending.find(event);
+    if (pending != _aggregation->pending.end()) {
+      // Within the window, or waiting for room under the rate limit.
+      pending->second.count++;
+      pending->second.attributes = std::move(attributes);
+    } else if (allowPublish(now)) {
+      if (_configuration.aggregation_window_ms > 0) {
+        _aggregation->pending[event] = PendingEvent{.window_start = now, .count = 0, .attributes = {}};
+      }
+      outgoing.push_back(OutgoingEvent{.event = std::move(event), .attributes = std::move(attributes), .count = 1});
+    } else {
+      _aggregation->pending[std::move(event)] =
+          PendingEvent{.window_start = now, .count = 1, .attributes = std::move(attributes)};
+    }
+  }
+
+  for (auto &out : outgoing) {
+    publishNow(out.event, out.attributes, out.count);
+  }
+}
+
+void HaEntityEvent::loop() {
+  if (!aggregates()) {
+    return;
+  }
+
+  std::vector<OutgoingEvent> outgoing;
+  {
+    std::lock_guard<SpinLock> guard(_aggregation->lock);
+    collectExpired(std::chrono::steady_clock::now(), outgoing);
+  }
+  for (auto &out : outgoing) {
+    publishNow(out.event, out.attributes, out.count);
+  }
+}
+
+bool HaEntityEvent::allowPublish(std::chrono::steady_clock::time_point now) {
+  if (_configuration.max_events_per_second == 0) {
+    return true;
+  }
+  if (now - _aggregation->second_start >= std::chrono::seconds(1)) {
+    _aggregation->second_start = now;
+    _aggregation->published_this_second = 0;
+  }
+  if (_aggregation->published_this_second < _configuration.max_events_per_second) {
+    _aggregation->published_this_second++;
+    return true;
+  }
+  return false;
+}
+
+void HaEntityEvent::collectExpired(std::chrono::steady_clock::time_point now, std::vector<OutgoingEvent> &outgoing) {
+  auto window = std::chrono::milliseconds(_configuration.aggregation_window_ms);
+  for (auto it = _aggregation->pending.begin(); it != _aggregation->pending.end();) {
+    auto &pending = it->second;
+    if (now - pending.window_start < window) {
+      ++it;
+    } else if (pending.count == 0) {
+      it = _aggregation->pending.erase(it);
+    } else if (allowPublish(now)) {
+      outgoing.push_back(
+          OutgoingEvent{.event = it->first, .attributes = std::move(pending.attributes), .count = pending.count});
+      it = _aggregation->pending.erase(it);
+    } else {
+      // Over the rate limit, try again from the next loop().
+      ++it;
+    }
+  }
+}
+
+void HaEntityEvent::publishNow(const std::string &event, const Attributes::Map &attributes, uint32_t count) {
   IJsonDocument doc;
   doc["event_type"] = event;
+  if (count > 0) {
+    doc[ATTRIBUTE_COUNT] = count;
+  }
 
-  Attributes::toJson(doc, attributes, {"event_type"});
+  // The count is only added when aggregating, else a user attribute named count is kept as before.
+  static const std::set<std::string> forbidden_keys = {"event_type"};
+  static const std::set<std::string> forbidden_keys_aggregated = {"event_type", ATTRIBUTE_COUNT};
+  Attributes::toJson(doc, attributes, aggregates() ? forbidden_keys_aggregated : forbidden_keys);
 
-  auto message = toJsonString(doc);
-  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id), message);
+  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id), toJsonString(doc));
 }
@@ -4,11 +4,16 @@
 #include "AttributeVariants.h"
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 /**
  * @brief Represent an Event that can be sent to Home Assistant.
@@ -33,6 +38,20 @@ public:
      * @brief the device class for for this event. None to not specify (default).
      */
     DeviceClass device_class = DeviceClass::None;
+
+    /**
+     * @brief If non zero, repeated events of the same event type within this many milliseconds are merged. The first
+     * event is published right away, the rest within the window are published as one event when the window ends, with
+     * the number of merged events in a "count" attribute. Requires calling loop().
+     */
+    uint32_t aggregation_window_ms = 0;
+
+    /**
+     * @brief If non zero, at most this many events are published per second. Events over the limit are merged by
+     * event type (see aggregation_window_ms) and published from loop() when there is room again. Requires calling
+     * loop().
+     */
+    uint16_t max_events_per_second = 0;
   };
 
   /**
@@ -63,11 +82,43 @@ public:
    */
   void publishEvent(std::string event, Attributes::Map attributes = {});
 
+  /**
+   * @brief Call regularly, e.g. from the Arduino loop() or a task, if aggregation_window_ms or max_events_per_second
+   * is set. Publishes merged events whose aggregation window has ended.
+   */
+  void loop();
+
+private:
+  struct PendingEvent {
+    std::chrono::steady_clock::time_point window_start;
+    uint32_t count = 0; // Events not yet published.
+    Attributes::Map attributes;
+  };
+
+  struct OutgoingEvent {
+    std::string event;
+    Attributes::Map attributes;
+    uint32_t count;
+  };
+
+  struct Aggregation {
+    homeassistantentities::SpinLock lock;
+    std::map<std::string, PendingEvent> pending;
+    std::chrono::steady_clock::time_point second_start;
+    uint16_t published_this_second = 0;
+  };
+
+  bool aggregates() const { return _aggregation != nullptr; }
+  bool allowPublish(std::chrono::steady_clock::time_point now);
+  void collectExpired(std::chrono::steady_clock::time_point now, std::vector<OutgoingEvent> &outgoing);
+  void publishNow(const std::string &event, const Attributes::Map &attributes, uint32_t count);
+
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _object_id;
+  homeassistantentities::InternedString _object_id;
   Configuration _configuration;
+  std::unique_ptr<Aggregation> _aggregation; // Only with aggregation_window_ms or max_events_per_second set.
 };
 
 #endif // __HA_ENTITY_EVENT_H__
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "HaEntityFan.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
+#include <iterator>
 
 #define COMPONENT "fan"
 #define OBJECT_ID "fan"
@@ -10,16 +12,23 @@
 #define OBJECT_ID_DIRECTION "direction"
 #define OBJECT_ID_OSCILLATION "oscillation"
 
+using namespace homeassistantentities;
+
+static constexpr std::string_view PAYLOAD_OSCILLATE_ON = "oscillate_on";
+static constexpr std::string_view PAYLOAD_OSCILLATE_OFF = "oscillate_off";
+
 HaEntityFan::HaEntityFan(HaBridge &ha_bridge, std::string name, std::string child_object_id,
                          Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
-      _configuration(configuration) {}
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
+      _configuration(configuration), _presets(_configuration.presets) {
+  _configuration.presets.clear();
+}
 
 void HaEntityFan::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -51,10 +60,10 @@ void HaEntityFan::publishConfiguration() {
     doc["speed_range_max"] = _configuration.speed_range_max;
   }
 
-  if (!_configuration.presets.empty()) {
+  if (!_presets.empty()) {
     JsonArrayType preset_modes_array = createJsonArray(doc, "preset_modes");
-    for (const std::string &preset : _configuration.presets) {
-      addToJsonArray(preset_modes_array, preset);
+    for (size_t i = 0; i < _presets.size(); i++) {
+      addToJsonArray(preset_modes_array, _presets.at(i));
     }
     doc["preset_mode_state_topic"] =
         _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_PRESET);
@@ -70,35 +79,156 @@ void HaEntityFan::publishConfiguration() {
 }
 
 void HaEntityFan::republishState() {
-  if (_on) {
-    publishIsOn(*_on);
+  republish(StateTopic::OnOff);
+  if (_configuration.with_speed) {
+    republish(StateTopic::Speed);
+  }
+  if (!_presets.empty()) {
+    republish(StateTopic::Preset);
+  }
+  if (_configuration.with_direction) {
+    republish(StateTopic::Direction);
+  }
+  if (_configuration.with_oscillation) {
+    republish(StateTopic::Oscillation);
   }
-  if (_speed) {
-    publishSpeed(*_speed);
+}
+
+void HaEntityFan::republish(StateTopic topic) {
+  _ha_bridge.republishState(_lock, stateTopic(topic), [this, topic]() -> std::optional<std::string> {
+    switch (topic) {
+    case StateTopic::OnOff:
+      return _on ? std::optional<std::string>(*_on ? PAYLOAD_ON : PAYLOAD_OFF) : std::nullopt;
+    case StateTopic::Speed:
+      return _speed ? std::optional(std::to_string(*_speed)) : std::nullopt;
+    case StateTopic::Preset:
+      return _preset ? std::optional<std::string>(_presets.at(*_preset)) : std::nullopt;
+    case StateTopic::Direction:
+      return _direction;
+    case StateTopic::Oscillation:
+      return _oscillation
+                 ? std::optional<std::string>(*_oscillation ? PAYLOAD_OSCILLATE_ON : PAYLOAD_OSCILLATE_OFF)
+                 : std::nullopt;
+    default:
+      return std::nullopt;
+    }
+  });
+}
+
+void HaEntityFan::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
+      [this](const std::string &message) {
+        if (message == PAYLOAD_ON || message == PAYLOAD_OFF) {
+          storeIfEmptyLocked(_lock, _on, message == PAYLOAD_ON);
+        }
+      });
+  if (_configuration.with_speed) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_SPEED),
+        [this](const std::string &message) {
+          char *end;
+          auto speed = std::strtoul(message.c_str(), &end, 10);
+          if (end != message.c_str() && *end == '\0') {
+            storeIfEmptyLocked(_lock, _speed, std::clamp(static_cast<uint32_t>(speed), _configuration.speed_range_min,
+                                                         _configuration.speed_range_max));
+          }
+        });
   }
-  if (_preset) {
-    publishPreset(*_preset);
+  if (!_presets.empty()) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_PRESET),
+        [this](const std::string &message) {
+          if (auto index = _presets.find(message)) {
+            storeIfEmptyLocked(_lock, _preset, *index);
+          }
+        });
   }
-  if (_direction) {
-    publishDirection(*_direction);
+  if (_configuration.with_direction) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_DIRECTION),
+        [this](const std::string &message) { storeIfEmptyLocked(_lock, _direction, message); });
   }
-  if (_oscillation) {
-    publishOscillation(*_oscillation);
+  if (_configuration.with_oscillation) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_OSCILLATION),
+        [this](const std::string &message) {
+          if (message == PAYLOAD_OSCILLATE_ON || message == PAYLOAD_OSCILLATE_OFF) {
+            storeIfEmptyLocked(_lock, _oscillation, message == PAYLOAD_OSCILLATE_ON);
+          }
+        });
   }
 }
 
+void HaEntityFan::saveState(std::string &record) {
+  std::optional<bool> on;
+  std::optional<uint32_t> speed;
+  std::optional<bool> oscillation;
+  std::optional<size_t> preset;
+  std::optional<std::string> direction;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    on = _on;
+    speed = _speed;
+    oscillation = _oscillation;
+    preset = _preset;
+    direction = _direction;
+  }
+
+  StateRecordWriter writer(record);
+  writer.put(on);
+  writer.put(speed);
+  writer.put(oscillation);
+  // The preset rather than its index, which changes if presets are added or removed in a new firmware.
+  writer.put(preset ? std::optional<std::string_view>(_presets.at(*preset)) : std::nullopt);
+  writer.put(direction);
+}
+
+bool HaEntityFan::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<bool> on;
+  std::optional<uint32_t> speed;
+  std::optional<bool> oscillation;
+  std::optional<std::string> preset;
+  std::optional<std::string> direction;
+  reader.get(on);
+  reader.get(speed);
+  reader.get(oscillation);
+  reader.get(preset);
+  reader.get(direction);
+  if (!reader.ok()) {
+    return false;
+  }
+
+  if (on) {
+    storeIfEmptyLocked(_lock, _on, *on);
+  }
+  if (speed && _configuration.with_speed) {
+    storeIfEmptyLocked(_lock, _speed,
+                       std::clamp(*speed, _configuration.speed_range_min, _configuration.speed_range_max));
+  }
+  if (oscillation && _configuration.with_oscillation) {
+    storeIfEmptyLocked(_lock, _oscillation, *oscillation);
+  }
+  if (preset) {
+    if (auto index = _presets.find(*preset)) {
+      storeIfEmptyLocked(_lock, _preset, *index);
+    }
+  }
+  if (direction && _configuration.with_direction) {
+    storeIfEmptyLocked(_lock, _direction, std::move(*direction));
+  }
+  return true;
+}
+
 void HaEntityFan::publishDirection(std::string direction) {
   if (!_configuration.with_direction) {
     return;
   }
-  _direction = direction;
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_DIRECTION), direction);
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::Direction), direction,
+                          [&]() { _direction = std::move(direction); });
 }
 
 void HaEntityFan::updateDirection(std::string direction) {
-  if (!_direction || *_direction != direction) {
-    publishDirection(direction);
+  if (!equalsLocked(_lock, _direction, direction)) {
+    publishDirection(std::move(direction));
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
   }
 }
 
@@ -106,9 +236,9 @@ bool HaEntityFan::setOnDirection(std::function<void(std::string)> callback) {
   if (!_configuration.with_direction) {
     return false;
   }
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_DIRECTION),
-      [callback](std::string, std::string message) { callback(message); });
+      [callback](std::string, std::string message) { callback(std::move(message)); });
 }
 
 //--------------------------------------
@@ -117,22 +247,23 @@ void HaEntityFan::publishOscillation(bool oscillation) {
   if (!_configuration.with_oscillation) {
     return;
   }
-  _oscillation = oscillation;
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_OSCILLATION),
-      oscillation ? "oscillate_on" : "oscillate_off");
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::Oscillation),
+                          oscillation ? PAYLOAD_OSCILLATE_ON : PAYLOAD_OSCILLATE_OFF,
+                          [&]() { _oscillation = oscillation; });
 }
 
 void HaEntityFan::updateOscillation(bool oscillation) {
-  if (!_oscillation || *_oscillation != oscillation) {
+  if (auto cached = loadLocked(_lock, _oscillation); !cached || *cached != oscillation) {
     publishOscillation(oscillation);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
   }
 }
 
 bool HaEntityFan::setOnOscillation(std::function<void(bool)> callback) {
   if (!_configuration.with_oscillation)
     return false;
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_OSCILLATION),
       [callback](std::string, std::string message) {
         callback(message == "ON" || message == "on" || message == "true" || message == "1" ||
@@ -147,15 +278,14 @@ void HaEntityFan::publishSpeed(uint32_t speed) {
     return;
   }
   speed = std::clamp(speed, _configuration.speed_range_min, _configuration.speed_range_max);
-  _speed = speed;
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_SPEED),
-      std::to_string(speed));
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::Speed), std::to_string(speed), [&]() { _speed = speed; });
 }
 
 void HaEntityFan::updateSpeed(uint32_t speed) {
-  if (!_speed || *_speed != speed) {
+  if (auto cached = loadLocked(_lock, _speed); !cached || *cached != speed) {
     publishSpeed(speed);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
   }
 }
 
@@ -163,64 +293,139 @@ bool HaEntityFan::setOnSpeed(std::function<void(uint32_t)> callback) {
   if (!_configuration.with_speed) {
     return false;
   }
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_SPEED),
-      [callback, config = _configuration](std::string, std::string message) {
-        uint32_t speed = std::clamp(static_cast<uint32_t>(std::atoi(message.c_str())), config.speed_range_min,
-                                    config.speed_range_max);
-        callback(speed);
+      [callback, min = _configuration.speed_range_min, max = _configuration.speed_range_max](std::string,
+                                                                                             std::string message) {
+        callback(std::clamp(static_cast<uint32_t>(std::atoi(message.c_str())), min, max));
       });
 }
 
 //--------------------------------------
 
-void HaEntityFan::publishPreset(std::string preset) {
-  auto presets = _configuration.presets;
-  if (presets.empty()) {
-    return;
-  }
+void HaEntityFan::publishPreset(std::string_view preset) {
   // Check if preset is in the list of allowed presets
-  if (std::find(presets.begin(), presets.end(), preset) == presets.end()) {
+  if (auto index = _presets.find(preset)) {
+    publishPreset(*index);
+  }
+}
+
+void HaEntityFan::publishPreset(size_t index) {
+  if (index >= _presets.size()) {
     return;
   }
-  _preset = preset;
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_PRESET), preset);
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::Preset), _presets.at(index), [&]() { _preset = index; });
 }
 
-void HaEntityFan::updatePreset(std::string preset) {
-  if (!_preset || *_preset != preset) {
-    publishPreset(preset);
+void HaEntityFan::updatePreset(std::string_view preset) {
+  if (auto index = _presets.find(preset)) {
+    updatePreset(*index);
+  }
+}
+
+void HaEntityFan::updatePreset(size_t index) {
+  if (!equalsLocked(_lock, _preset, index)) {
+    publishPreset(index);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
   }
 }
 
 bool HaEntityFan::setOnPreset(std::function<void(std::string)> callback) {
-  if (_configuration.presets.empty()) {
+  if (_presets.empty()) {
     return false;
   }
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_PRESET),
-      [callback](std::string, std::string message) { callback(message); });
+      [this, callback](std::string, std::string message) {
+        if (_presets.find(message)) {
+          callback(std::move(message));
+        }
+      });
 }
 
 //--------------------------------------
 
 void HaEntityFan::publishIsOn(bool on) {
-  _on = on;
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF), on ? "ON" : "OFF");
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::OnOff), on ? PAYLOAD_ON : PAYLOAD_OFF, [&]() { _on = on; });
 }
 
 void HaEntityFan::updateIsOn(bool on) {
-  if (!_on || *_on != on) {
+  if (auto cached = loadLocked(_lock, _on); !cached || *cached != on) {
     publishIsOn(on);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
   }
 }
 
 bool HaEntityFan::setOnState(std::function<void(bool)> callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
       [callback](std::string, std::string message) {
         callback(message == "ON" || message == "on" || message == "true" || message == "1");
       });
-}
\ No newline at end of file
+}
+
+//--------------------------------------
+
+void HaEntityFan::update(const State &state) {
+  State changed;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    if (state.on && _on != state.on) {
+      _on = changed.on = state.on;
+    }
+    if (_configuration.with_speed && state.speed) {
+      auto speed = std::clamp(*state.speed, _configuration.speed_range_min, _configuration.speed_range_max);
+      if (_speed != speed) {
+        _speed = changed.speed = speed;
+      }
+    }
+    if (_configuration.with_oscillation && state.oscillation && _oscillation != state.oscillation) {
+      _oscillation = changed.oscillation = state.oscillation;
+    }
+    if (state.preset) {
+      if (auto index = _presets.find(*state.preset); index && _preset != index) {
+        _preset = index;
+        changed.preset = state.preset;
+      }
+    }
+    if (_configuration.with_direction && state.direction && _direction != state.direction) {
+      _direction = changed.direction = state.direction;
+    }
+  }
+
+  if (!changed.on && !changed.speed && !changed.oscillation && !changed.preset && !changed.direction) {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Fan);
+    return;
+  }
+
+  // Republished from the cache rather than from changed, so if another task changed a field since, its newer value is
+  // the one queued last.
+  if (changed.on) {
+    republish(StateTopic::OnOff);
+  }
+  if (changed.speed) {
+    republish(StateTopic::Speed);
+  }
+  if (changed.preset) {
+    republish(StateTopic::Preset);
+  }
+  if (changed.direction) {
+    republish(StateTopic::Direction);
+  }
+  if (changed.oscillation) {
+    republish(StateTopic::Oscillation);
+  }
+}
+
+const std::string &HaEntityFan::stateTopic(StateTopic topic) {
+  // Object ID of each StateTopic, in order.
+  static constexpr const char *object_ids[] = {OBJECT_ID_ONOFF, OBJECT_ID_SPEED, OBJECT_ID_PRESET, OBJECT_ID_DIRECTION,
+                                               OBJECT_ID_OSCILLATION};
+  static_assert(std::size(object_ids) == static_cast<size_t>(StateTopic::Count));
+  auto index = static_cast<size_t>(topic);
+  return _state_topics.get(_lock, index, [this, index]() {
+    return _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, object_ids[index]);
+  });
+}
@@ -2,11 +2,16 @@
 #define __HA_ENTITY_FAN_H__
 
 #include <HaBridge.h>
+#include <HaCachedTopic.h>
 #include <HaEntity.h>
+#include <HaOptionIndex.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Represent a fan with speed.
@@ -45,7 +50,8 @@ public:
     uint32_t speed_range_max = 100;
 
     /**
-     * @brief If non empty, the presets this fan supports.
+     * @brief If non empty, the presets this fan supports. Each preset has an index, its position in the set (sorted
+     * order), which can be used instead of the preset itself, see publishPreset(size_t).
      */
     std::set<std::string> presets = {};
 
@@ -96,6 +102,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the direction. This will publish to MQTT regardless if the value has changed. Also see
@@ -189,21 +198,34 @@ public:
    *
    * presets in Configuration must be set to a non empty set.
    *
-   * @param preset the preset.
+   * @param preset the preset. Presets not in Configuration are ignored.
    */
-  void publishPreset(std::string preset);
+  void publishPreset(std::string_view preset);
+
+  /**
+   * @brief Same as above, but with the index of the preset in presets in Configuration. Out of range indices are
+   * ignored.
+   */
+  void publishPreset(size_t index);
 
   /**
    * @brief Publish a preset, but only if the value has changed. Also see publishPreset().
    *
    * presets in Configuration must be set to a non empty set.
    *
-   * @param preset the preset.
+   * @param preset the preset. Presets not in Configuration are ignored.
+   */
+  void updatePreset(std::string_view preset);
+
+  /**
+   * @brief Same as above, but with the index of the preset in presets in Configuration. Out of range indices are
+   * ignored.
    */
-  void updatePreset(std::string preset);
+  void updatePreset(size_t index);
 
   /**
-   * @brief Set callback for receiving callbacks when a new preset should be set.
+   * @brief Set callback for receiving callbacks when a new preset should be set. Commands with a preset not in
+   * Configuration are ignored.
    *
    * presets in Configuration must be set to a non empty set.
    */
@@ -231,17 +253,49 @@ public:
    */
   bool setOnState(std::function<void(bool)> callback);
 
+  //--------------------------------------
+
+  /**
+   * @brief Several fields of the fan state, for update(). Fields left empty are not changed.
+   */
+  struct State {
+    std::optional<bool> on;
+    std::optional<uint32_t> speed;
+    std::optional<bool> oscillation;
+    std::optional<std::string> preset;
+    std::optional<std::string> direction;
+  };
+
+  /**
+   * @brief Update several fields at once, publishing only the fields that have changed. Fields for capabilities not
+   * setup in the Configuration, and presets not in the Configuration, are ignored. Same as calling updateIsOn(),
+   * updateSpeed() and so on, but with one lock and one comparison pass.
+   *
+   * @param state the fields to update.
+   */
+  void update(const State &state);
+
+private:
+  // The state topics, see stateTopic().
+  enum class StateTopic : uint8_t { OnOff, Speed, Preset, Direction, Oscillation, Count };
+
+  const std::string &stateTopic(StateTopic topic);
+  void republish(StateTopic topic);
+
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
-  Configuration _configuration;
+  homeassistantentities::InternedString _child_object_id;
+  Configuration _configuration; // Without the presets, these are in _presets.
+  homeassistantentities::OptionIndex _presets;
 
 private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
+  homeassistantentities::CachedTopics<static_cast<size_t>(StateTopic::Count)> _state_topics;
   std::optional<bool> _on;
   std::optional<uint32_t> _speed;
   std::optional<bool> _oscillation;
-  std::optional<std::string> _preset;
+  std::optional<size_t> _preset; // Index in _presets.
   std::optional<std::string> _direction;
 };
 
@@ -1,6 +1,9 @@
 #include "HaEntityLight.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
+#include <algorithm>
+#include <iterator>
 #include <regex>
 #include <string>
 
@@ -11,8 +14,15 @@
 #define OBJECT_ID_EFFECT "effect"
 #define OBJECT_ID_BRIGHTNESS "brightness"
 #define OBJECT_ID_COLOR_TEMPERATURE "color_temperature"
+#define OBJECT_ID_JSON "json"
 
-HaEntityLight::RGB extractColor(std::string &input) {
+using namespace homeassistantentities;
+
+static std::string rgbToPayload(const HaEntityLight::RGB &rgb) {
+  return std::to_string(rgb.r) + "," + std::to_string(rgb.g) + "," + std::to_string(rgb.b);
+}
+
+HaEntityLight::RGB extractColor(const std::string &input) {
   HaEntityLight::RGB color;
   static std::regex pattern(R"((\d+),(\d+),(\d+))");
   std::smatch matches;
@@ -29,24 +39,94 @@ HaEntityLight::RGB extractColor(std::string &input) {
   return color;
 }
 
+static uint8_t clampToUint8(int value) { return static_cast<uint8_t>(std::min(std::max(value, 0), 255)); }
+
+// Extract a JSON schema command, like {"state":"ON","brightness":128,"color":{"r":255,"g":0,"b":0},"transition":2}
+static bool extractCommand(const std::string &message, HaEntityLight::Command &command) {
+  IJsonDocument doc;
+  if (!parseJsonString(doc, message) || !isJsonObject(doc)) {
+    return false;
+  }
+
+  if (isJsonString(doc["state"])) {
+    command.on = getJsonValue(doc["state"], std::string) == "ON";
+  }
+  if (isJsonNumber(doc["brightness"])) {
+    command.brightness = clampToUint8(getJsonValue(doc["brightness"], int));
+  }
+  if (isJsonNumber(doc["color_temp"])) {
+    auto temperature = std::min(std::max(getJsonValue(doc["color_temp"], int), 0), 65535);
+    command.color_temperature = static_cast<uint16_t>(temperature);
+  }
+  if (isJsonObject(doc["color"]) && isJsonNumber(doc["color"]["r"]) && isJsonNumber(doc["color"]["g"]) &&
+      isJsonNumber(doc["color"]["b"])) {
+    command.rgb = HaEntityLight::RGB{clampToUint8(getJsonValue(doc["color"]["r"], int)),
+                                     clampToUint8(getJsonValue(doc["color"]["g"], int)),
+                                     clampToUint8(getJsonValue(doc["color"]["b"], int))};
+  }
+  if (isJsonString(doc["effect"])) {
+    command.effect = getJsonValue(doc["effect"], std::string);
+  }
+  if (isJsonNumber(doc["transition"])) {
+    command.transition = getJsonValue(doc["transition"], float);
+  }
+  return true;
+}
+
 // NOTE! We have swapped object ID and child object ID to get a nicer state/command topic path.
 
 HaEntityLight::HaEntityLight(HaBridge &ha_bridge, std::string name, std::string child_object_id,
                              Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
-      _configuration(configuration) {}
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
+      _configuration(configuration), _effects(_configuration.effects) {
+  _configuration.effects.clear();
+}
 
 void HaEntityLight::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
 
   doc["retain"] = _configuration.retain;
 
+  if (isJsonSchema()) {
+    doc["schema"] = "json";
+    doc["state_topic"] = _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_JSON);
+    doc["command_topic"] =
+        _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_JSON);
+    doc["brightness"] = _configuration.with_brightness;
+
+    JsonArrayType color_modes_array = createJsonArray(doc, "supported_color_modes");
+    if (_configuration.with_rgb_color) {
+      addToJsonArray(color_modes_array, "rgb");
+    }
+    if (_configuration.with_color_temperature != Configuration::ColorTemperature::None) {
+      addToJsonArray(color_modes_array, "color_temp");
+      if (_configuration.with_color_temperature == Configuration::ColorTemperature::Kelvin) {
+        doc["color_temp_kelvin"] = true;
+      }
+    }
+    if (!_configuration.with_rgb_color &&
+        _configuration.with_color_temperature == Configuration::ColorTemperature::None) {
+      addToJsonArray(color_modes_array, _configuration.with_brightness ? "brightness" : "onoff");
+    }
+
+    if (!_effects.empty()) {
+      doc["effect"] = true;
+      JsonArrayType effect_list_array = createJsonArray(doc, "effect_list");
+      for (size_t i = 0; i < _effects.size(); i++) {
+        addToJsonArray(effect_list_array, _effects.at(i));
+      }
+    }
+
+    _ha_bridge.publishConfiguration(COMPONENT, OBJECT_ID, _child_object_id, doc);
+    return;
+  }
+
   doc["state_topic"] = _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF);
   doc["command_topic"] =
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_ONOFF);
@@ -71,15 +151,15 @@ void HaEntityLight::publishConfiguration() {
     doc["rgb_command_topic"] =
         _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_RGB);
   }
-  if (!_configuration.effects.empty()) {
+  if (!_effects.empty()) {
     doc["effect_state_topic"] =
         _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_EFFECT);
     doc["effect_command_topic"] =
         _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_EFFECT);
 
     JsonArrayType effect_list_array = createJsonArray(doc, "effect_list");
-    for (const std::string &effect : _configuration.effects) {
-      addToJsonArray(effect_list_array, effect);
+    for (size_t i = 0; i < _effects.size(); i++) {
+      addToJsonArray(effect_list_array, _effects.at(i));
     }
   }
 
@@ -87,97 +167,470 @@ void HaEntityLight::publishConfiguration() {
 }
 
 void HaEntityLight::republishState() {
-  if (_on) {
-    publishIsOn(*_on);
+  if (isJsonSchema()) {
+    publishJsonState();
+    return;
   }
-  if (_brightness) {
-    publishBrightness(*_brightness);
+
+  republish(StateTopic::OnOff);
+  if (_configuration.with_brightness) {
+    republish(StateTopic::Brightness);
   }
-  if (_color_temperature) {
-    publishColorTemperature(*_color_temperature);
+  if (_configuration.with_color_temperature != Configuration::ColorTemperature::None) {
+    republish(StateTopic::ColorTemperature);
   }
-  if (_rgb) {
-    publishRgb(*_rgb);
+  if (_configuration.with_rgb_color) {
+    republish(StateTopic::Rgb);
   }
-  if (_effect) {
-    publishEffect(*_effect);
+  if (!_effects.empty()) {
+    republish(StateTopic::Effect);
   }
 }
 
+void HaEntityLight::restoreState(const StateRestorer &add) {
+  if (isJsonSchema()) {
+    // The state has the same fields as a command.
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_JSON),
+        [this](const std::string &message) {
+          Command state;
+          if (!extractCommand(message, state)) {
+            return;
+          }
+          std::lock_guard<SpinLock> guard(_lock);
+          if (!_on) {
+            _on = state.on;
+          }
+          if (!_brightness && _configuration.with_brightness) {
+            _brightness = state.brightness;
+          }
+          if (!_color_temperature && _configuration.with_color_temperature != Configuration::ColorTemperature::None) {
+            _color_temperature = state.color_temperature;
+          }
+          if (!_rgb && _configuration.with_rgb_color) {
+            _rgb = state.rgb;
+          }
+          if (!_effect && state.effect) {
+            _effect = _effects.find(*state.effect);
+          }
+        });
+    return;
+  }
+
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
+      [this](const std::string &message) {
+        if (message == PAYLOAD_ON || message == PAYLOAD_OFF) {
+          storeIfEmptyLocked(_lock, _on, message == PAYLOAD_ON);
+        }
+      });
+  if (_configuration.with_brightness) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_BRIGHTNESS),
+        [this](const std::string &message) {
+          storeIfEmptyLocked(_lock, _brightness, clampToUint8(std::atoi(message.c_str())));
+        });
+  }
+  if (_configuration.with_color_temperature != Configuration::ColorTemperature::None) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_COLOR_TEMPERATURE),
+        [this](const std::string &message) {
+          auto temperature = std::min(std::max(std::atoi(message.c_str()), 0), 65535);
+          storeIfEmptyLocked(_lock, _color_temperature, static_cast<uint16_t>(temperature));
+        });
+  }
+  if (_configuration.with_rgb_color) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_RGB),
+        [this](const std::string &message) { storeIfEmptyLocked(_lock, _rgb, extractColor(message)); });
+  }
+  if (!_effects.empty()) {
+    add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_EFFECT),
+        [this](const std::string &message) {
+          if (auto index = _effects.find(message)) {
+            storeIfEmptyLocked(_lock, _effect, *index);
+          }
+        });
+  }
+}
+
+void HaEntityLight::saveState(std::string &record) {
+  std::optional<bool> on;
+  std::optional<RGB> rgb;
+  std::optional<size_t> effect;
+  std::optional<uint8_t> brightness;
+  std::optional<uint16_t> color_temperature;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    on = _on;
+    rgb = _rgb;
+    effect = _effect;
+    brightness = _brightness;
+    color_temperature = _color_temperature;
+  }
+
+  StateRecordWriter writer(record);
+  writer.put(on);
+  writer.put(brightness);
+  writer.put(color_temperature);
+  writer.put(rgb.has_value());
+  if (rgb) {
+    writer.put(rgb->r);
+    writer.put(rgb->g);
+    writer.put(rgb->b);
+  }
+  // The effect rather than its index, which changes if effects are added or removed in a new firmware.
+  writer.put(effect ? std::optional<std::string_view>(_effects.at(*effect)) : std::nullopt);
+}
+
+bool HaEntityLight::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<bool> on;
+  std::optional<uint8_t> brightness;
+  std::optional<uint16_t> color_temperature;
+  bool has_rgb;
+  RGB rgb = {};
+  std::optional<std::string> effect;
+  reader.get(on);
+  reader.get(brightness);
+  reader.get(color_temperature);
+  reader.get(has_rgb);
+  if (has_rgb) {
+    reader.get(rgb.r);
+    reader.get(rgb.g);
+    reader.get(rgb.b);
+  }
+  reader.get(effect);
+  if (!reader.ok()) {
+    return false;
+  }
+
+  if (on) {
+    storeIfEmptyLocked(_lock, _on, *on);
+  }
+  if (brightness && _configuration.with_brightness) {
+    storeIfEmptyLocked(_lock, _brightness, *brightness);
+  }
+  if (color_temperature && _configuration.with_color_temperature != Configuration::ColorTemperature::None) {
+    storeIfEmptyLocked(_lock, _color_temperature, *color_temperature);
+  }
+  if (has_rgb && _configuration.with_rgb_color) {
+    storeIfEmptyLocked(_lock, _rgb, rgb);
+  }
+  if (effect) {
+    if (auto index = _effects.find(*effect)) {
+      storeIfEmptyLocked(_lock, _effect, *index);
+    }
+  }
+  return true;
+}
+
 void HaEntityLight::publishIsOn(bool on) {
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
-      std::string(on ? "ON" : "OFF"));
-  _on = on;
+  if (isJsonSchema()) {
+    storeLocked(_lock, _on, on);
+    publishJsonState();
+    return;
+  }
+
+  _ha_bridge.publishState(_lock, stateTopic(StateTopic::OnOff), on ? PAYLOAD_ON : PAYLOAD_OFF, [&]() { _on = on; });
 }
 
 void HaEntityLight::publishBrightness(uint8_t brightness) {
   if (_configuration.with_brightness) {
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_BRIGHTNESS),
-        std::to_string(brightness));
-    _brightness = brightness;
+    if (isJsonSchema()) {
+      storeLocked(_lock, _brightness, brightness);
+      publishJsonState();
+      return;
+    }
+
+    _ha_bridge.publishState(_lock, stateTopic(StateTopic::Brightness), std::to_string(brightness),
+                            [&]() { _brightness = brightness; });
   }
 }
 
 void HaEntityLight::publishColorTemperature(uint16_t temperature) {
   if (_configuration.with_color_temperature != Configuration::ColorTemperature::None) {
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_COLOR_TEMPERATURE),
-        std::to_string(temperature));
-    _color_temperature = temperature;
+    auto store = [&]() {
+      _color_temperature = temperature;
+      _rgb_color_mode = false;
+    };
+    if (isJsonSchema()) {
+      {
+        std::lock_guard<SpinLock> guard(_lock);
+        store();
+      }
+      publishJsonState();
+      return;
+    }
+
+    _ha_bridge.publishState(_lock, stateTopic(StateTopic::ColorTemperature), std::to_string(temperature), store);
   }
 }
 
 void HaEntityLight::publishRgb(RGB rgb) {
   if (_configuration.with_rgb_color) {
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_RGB),
-        std::to_string(rgb.r) + "," + std::to_string(rgb.g) + "," + std::to_string(rgb.b));
-    _rgb = rgb;
+    auto store = [&]() {
+      _rgb = rgb;
+      _rgb_color_mode = true;
+    };
+    if (isJsonSchema()) {
+      {
+        std::lock_guard<SpinLock> guard(_lock);
+        store();
+      }
+      publishJsonState();
+      return;
+    }
+
+    _ha_bridge.publishState(_lock, stateTopic(StateTopic::Rgb), rgbToPayload(rgb), store);
   }
 }
 
-void HaEntityLight::publishEffect(std::string effect) {
-  if (!_configuration.effects.empty()) {
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_EFFECT), effect);
-    _effect = effect;
+void HaEntityLight::publishEffect(std::string_view effect) {
+  if (auto index = _effects.find(effect)) {
+    publishEffect(*index);
   }
 }
 
+void HaEntityLight::publishEffect(size_t index) {
+  if (index < _effects.size()) {
+    if (isJsonSchema()) {
+      storeLocked(_lock, _effect, index);
+      publishJsonState();
+      return;
+    }
+
+    _ha_bridge.publishState(_lock, stateTopic(StateTopic::Effect), _effects.at(index), [&]() { _effect = index; });
+  }
+}
+
+void HaEntityLight::publishJsonState() {
+  // Serialized under the lock, so with a queue the message queued last is always the latest state, also when several
+  // tasks change the light (see HaBridge::publishState()).
+  _ha_bridge.republishState(_lock, stateTopic(StateTopic::Json), [this]() { return jsonState(); });
+}
+
+std::optional<std::string> HaEntityLight::jsonState() const {
+  // Home Assistant needs the state in every message. Until it is known, the other fields are only cached and will be
+  // published together with the state.
+  if (!_on) {
+    return std::nullopt;
+  }
+
+  IJsonDocument doc;
+  doc["state"] = *_on ? "ON" : "OFF";
+  if (_brightness) {
+    doc["brightness"] = *_brightness;
+  }
+
+  bool with_color_temperature = _configuration.with_color_temperature != Configuration::ColorTemperature::None;
+  if (_configuration.with_rgb_color && (_rgb_color_mode || !with_color_temperature)) {
+    doc["color_mode"] = "rgb";
+  } else if (with_color_temperature) {
+    doc["color_mode"] = "color_temp";
+  } else {
+    doc["color_mode"] = _configuration.with_brightness ? "brightness" : "onoff";
+  }
+  if (_color_temperature) {
+    doc["color_temp"] = *_color_temperature;
+  }
+  if (_rgb) {
+    doc["color"]["r"] = _rgb->r;
+    doc["color"]["g"] = _rgb->g;
+    doc["color"]["b"] = _rgb->b;
+  }
+  if (_effect) {
+    doc["effect"] = _effects.at(*_effect);
+  }
+  return toJsonString(doc);
+}
+
+void HaEntityLight::republish(StateTopic topic) {
+  _ha_bridge.republishState(_lock, stateTopic(topic), [this, topic]() -> std::optional<std::string> {
+    switch (topic) {
+    case StateTopic::OnOff:
+      return _on ? std::optional<std::string>(*_on ? PAYLOAD_ON : PAYLOAD_OFF) : std::nullopt;
+    case StateTopic::Brightness:
+      return _brightness ? std::optional(std::to_string(*_brightness)) : std::nullopt;
+    case StateTopic::ColorTemperature:
+      return _color_temperature ? std::optional(std::to_string(*_color_temperature)) : std::nullopt;
+    case StateTopic::Rgb:
+      return _rgb ? std::optional(rgbToPayload(*_rgb)) : std::nullopt;
+    case StateTopic::Effect:
+      return _effect ? std::optional<std::string>(_effects.at(*_effect)) : std::nullopt;
+    default:
+      return std::nullopt;
+    }
+  });
+}
+
+const std::string &HaEntityLight::stateTopic(StateTopic topic) {
+  // Object ID of each StateTopic, in order.
+  static constexpr const char *object_ids[] = {OBJECT_ID_ONOFF, OBJECT_ID_BRIGHTNESS, OBJECT_ID_COLOR_TEMPERATURE,
+                                               OBJECT_ID_RGB,   OBJECT_ID_EFFECT,     OBJECT_ID_JSON};
+  static_assert(std::size(object_ids) == static_cast<size_t>(StateTopic::Count));
+  auto index = static_cast<size_t>(topic);
+  return _state_topics.get(_lock, index, [this, index]() {
+    return _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, object_ids[index]);
+  });
+}
+
 void HaEntityLight::updateIsOn(bool on) {
-  if (!_on || *_on != on) {
+  if (auto cached = loadLocked(_lock, _on); !cached || *cached != on) {
     publishIsOn(on);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
   }
 }
 
 void HaEntityLight::updateBrightness(uint8_t brightness) {
-  if (!_brightness || *_brightness != brightness) {
+  if (auto cached = loadLocked(_lock, _brightness); !cached || *cached != brightness) {
     publishBrightness(brightness);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
   }
 }
 
 void HaEntityLight::updateColorTemperature(uint16_t temperature) {
-  if (!_color_temperature || *_color_temperature != temperature) {
+  if (auto cached = loadLocked(_lock, _color_temperature); !cached || *cached != temperature) {
     publishColorTemperature(temperature);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
   }
 }
 
 void HaEntityLight::updateRgb(RGB rgb) {
-  if (!_rgb || *_rgb != rgb) {
+  if (auto cached = loadLocked(_lock, _rgb); !cached || *cached != rgb) {
     publishRgb(rgb);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
+  }
+}
+
+void HaEntityLight::updateEffect(std::string_view effect) {
+  if (auto index = _effects.find(effect)) {
+    updateEffect(*index);
+  }
+}
+
+void HaEntityLight::updateEffect(size_t index) {
+  if (!equalsLocked(_lock, _effect, index)) {
+    publishEffect(index);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
+  }
+}
+
+void HaEntityLight::update(const State &state) {
+  State changed;
+  {
+    std::lock_guard<SpinLock> guard(_lock);
+    if (state.on && _on != state.on) {
+      _on = changed.on = state.on;
+    }
+    if (_configuration.with_brightness && state.brightness && _brightness != state.brightness) {
+      _brightness = changed.brightness = state.brightness;
+    }
+    if (_configuration.with_color_temperature != Configuration::ColorTemperature::None && state.color_temperature &&
+        _color_temperature != state.color_temperature) {
+      _color_temperature = changed.color_temperature = state.color_temperature;
+      _rgb_color_mode = false;
+    }
+    if (_configuration.with_rgb_color && state.rgb && _rgb != state.rgb) {
+      _rgb = changed.rgb = state.rgb;
+      _rgb_color_mode = true;
+    }
+    if (state.effect) {
+      if (auto index = _effects.find(*state.effect); index && _effect != index) {
+        _effect = index;
+        changed.effect = state.effect;
+      }
+    }
+  }
+
+  if (!changed.on && !changed.brightness && !changed.color_temperature && !changed.rgb && !changed.effect) {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Light);
+    return;
+  }
+
+  if (isJsonSchema()) {
+    publishJsonState();
+    return;
+  }
+
+  // Republished from the cache rather than from changed, so if another task changed a field since, its newer value is
+  // the one queued last.
+  if (changed.on) {
+    republish(StateTopic::OnOff);
+  }
+  if (changed.brightness) {
+    republish(StateTopic::Brightness);
+  }
+  if (changed.color_temperature) {
+    republish(StateTopic::ColorTemperature);
+  }
+  if (changed.rgb) {
+    republish(StateTopic::Rgb);
+  }
+  if (changed.effect) {
+    republish(StateTopic::Effect);
   }
 }
 
-void HaEntityLight::updateEffect(std::string effect) {
-  if (!_effect || *_effect != effect) {
-    publishEffect(effect);
+bool HaEntityLight::setOnCommand(std::function<void(const Command &)> callback) {
+  if (!isJsonSchema()) {
+    return false;
   }
+
+  return addCommandCallback(callback);
+}
+
+bool HaEntityLight::addCommandCallback(std::function<void(const Command &)> callback) {
+  // Copy on write, allocating outside the lock. Retried if another callback was added meanwhile.
+  std::shared_ptr<const CommandCallbacks> current;
+  bool first;
+  while (true) {
+    current = loadCommandCallbacks();
+    auto callbacks = current ? std::make_shared<CommandCallbacks>(*current) : std::make_shared<CommandCallbacks>();
+    callbacks->push_back(callback);
+
+    std::lock_guard<SpinLock> guard(_lock);
+    if (_command_callbacks == current) {
+      first = !current;
+      _command_callbacks = std::move(callbacks);
+      break;
+    }
+  }
+  if (!first) {
+    return true;
+  }
+
+  // One subscription for all callbacks. A command only has the fields that changed, so commands can not be coalesced.
+  return _ha_bridge.subscribe(
+      _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_JSON),
+      [this](std::string topic, std::string message) {
+        Command command;
+        if (!extractCommand(message, command)) {
+          return;
+        }
+        auto callbacks = loadCommandCallbacks();
+        for (auto &command_callback : *callbacks) {
+          command_callback(command);
+        }
+      },
+      false);
+}
+
+std::shared_ptr<const HaEntityLight::CommandCallbacks> HaEntityLight::loadCommandCallbacks() {
+  std::lock_guard<SpinLock> guard(_lock);
+  return _command_callbacks;
 }
 
 bool HaEntityLight::setOnOn(std::function<void(bool)> state_callback) {
-  return _ha_bridge.remote().subscribe(
+  if (isJsonSchema()) {
+    return addCommandCallback([state_callback](const Command &command) {
+      if (command.on) {
+        state_callback(*command.on);
+      }
+    });
+  }
+
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
       [state_callback](std::string topic, std::string message) { state_callback(message == "ON"); });
 }
@@ -187,7 +640,15 @@ bool HaEntityLight::setOnBrightness(std::function<void(uint8_t)> callback) {
     return false;
   }
 
-  return _ha_bridge.remote().subscribe(
+  if (isJsonSchema()) {
+    return addCommandCallback([callback](const Command &command) {
+      if (command.brightness) {
+        callback(*command.brightness);
+      }
+    });
+  }
+
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_BRIGHTNESS),
       [callback](std::string topic, std::string message) { callback(std::atoi(message.c_str())); });
 }
@@ -197,7 +658,15 @@ bool HaEntityLight::setOnColorTemperature(std::function<void(uint16_t)> callback
     return false;
   }
 
-  return _ha_bridge.remote().subscribe(
+  if (isJsonSchema()) {
+    return addCommandCallback([callback](const Command &command) {
+      if (command.color_temperature) {
+        callback(*command.color_temperature);
+      }
+    });
+  }
+
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_COLOR_TEMPERATURE),
       [callback](std::string topic, std::string message) { callback(std::atoi(message.c_str())); });
 }
@@ -207,7 +676,15 @@ bool HaEntityLight::setOnRgb(std::function<void(RGB)> callback) {
     return false;
   }
 
-  return _ha_bridge.remote().subscribe(
+  if (isJsonSchema()) {
+    return addCommandCallback([callback](const Command &command) {
+      if (command.rgb) {
+        callback(*command.rgb);
+      }
+    });
+  }
+
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_RGB),
       [callback](std::string topic, std::string message) {
         RGB rgb = extractColor(message);
@@ -216,11 +693,23 @@ bool HaEntityLight::setOnRgb(std::function<void(RGB)> callback) {
 }
 
 bool HaEntityLight::setOnEffect(std::function<void(std::string)> callback) {
-  if (_configuration.effects.empty()) {
+  if (_effects.empty()) {
     return false;
   }
 
-  return _ha_bridge.remote().subscribe(
+  if (isJsonSchema()) {
+    return addCommandCallback([this, callback](const Command &command) {
+      if (command.effect && _effects.find(*command.effect)) {
+        callback(*command.effect);
+      }
+    });
+  }
+
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_EFFECT),
-      [callback](std::string topic, std::string message) { callback(message); });
+      [this, callback](std::string topic, std::string message) {
+        if (_effects.find(message)) {
+          callback(std::move(message));
+        }
+      });
 }
@@ -2,12 +2,19 @@
 #define __HA_ENTITY_LIGHT_H__
 
 #include <HaBridge.h>
+#include <HaCachedTopic.h>
 #include <HaEntity.h>
+#include <HaOptionIndex.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <functional>
 #include <optional>
 #include <set>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 /**
  * @brief Represent a Light that can be controlled from Home Assistant. It goes two ways, as the light can be changed
@@ -39,7 +46,8 @@ public:
     bool with_rgb_color = false;
 
     /**
-     * @brief if non empty, the supported effects.
+     * @brief if non empty, the supported effects. Each effect has an index, its position in the set (sorted order),
+     * which can be used instead of the effect itself, see publishEffect(size_t).
      */
     std::set<std::string> effects = {};
 
@@ -47,6 +55,18 @@ public:
      * @brief If true, this tells Home Assistant to publish the message on the command topic with retain set to true.
      */
     bool retain = false;
+
+    enum class Schema {
+      Default, // One state and one command topic per capability.
+      Json,    // One state and one command topic for everything, with JSON payloads.
+    };
+
+    /**
+     * @brief The MQTT schema to use. With Schema::Json, every publishX() and updateX() publishes the complete state
+     * of the light in one message, so Home Assistant never sees a partial state, and Home Assistant sends all changes
+     * (including transition) in one command. See setOnCommand().
+     */
+    Schema schema = Schema::Default;
   };
 
   /**
@@ -73,6 +93,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the current on state. This will publish to MQTT regardless if the value has changed. Also see
@@ -129,17 +152,29 @@ public:
    * updateEffect().
    *
    * @param effect currently selected. Should be any of the effects from the Capabilities. Will only be published if the
-   * light is setup with this capability in the Configuration.
+   * light is setup with this capability in the Configuration. Effects not in the Configuration are ignored.
+   */
+  void publishEffect(std::string_view effect);
+
+  /**
+   * @brief Same as above, but with the index of the effect in effects in Configuration. Out of range indices are
+   * ignored.
    */
-  void publishEffect(std::string effect);
+  void publishEffect(size_t index);
 
   /**
    * @brief Publish the current selected effect, but only if the value has changed. Also see publishEffect().
    *
    * @param effect currently selected. Should be any of the effects from the Capabilities. Will only be published if the
-   * light is setup with this capability in the Configuration.
+   * light is setup with this capability in the Configuration. Effects not in the Configuration are ignored.
    */
-  void updateEffect(std::string effect);
+  void updateEffect(std::string_view effect);
+
+  /**
+   * @brief Same as above, but with the index of the effect in effects in Configuration. Out of range indices are
+   * ignored.
+   */
+  void updateEffect(size_t index);
 
   struct RGB {
     uint8_t r;
@@ -185,6 +220,47 @@ public:
    */
   void updateRgb(RGB rgb);
 
+  /**
+   * @brief Several fields of the light state, for update(). Fields left empty are not changed.
+   */
+  struct State {
+    std::optional<bool> on;
+    std::optional<uint8_t> brightness;
+    std::optional<uint16_t> color_temperature; // mireds or Kelvin, depending on what was selected in the Configuration.
+    std::optional<RGB> rgb;
+    std::optional<std::string> effect;
+  };
+
+  /**
+   * @brief Update several fields at once, like when changing scene, publishing only the fields that have changed. With
+   * Configuration::Schema::Json, this is at most one message. Fields for capabilities not setup in the Configuration
+   * are ignored. Same as calling updateIsOn(), updateBrightness() and so on, but with one lock and one comparison
+   * pass.
+   *
+   * @param state the fields to update.
+   */
+  void update(const State &state);
+
+  /**
+   * @brief A command from Home Assistant when using Configuration::Schema::Json. Only the fields present in the
+   * command are set.
+   */
+  struct Command {
+    std::optional<bool> on;
+    std::optional<uint8_t> brightness;
+    std::optional<uint16_t> color_temperature; // mireds or Kelvin, depending on what was selected in the Configuration.
+    std::optional<RGB> rgb;
+    std::optional<std::string> effect;
+    std::optional<float> transition; // In seconds.
+  };
+
+  /**
+   * @brief Set callback for receiving the complete command from Home Assistant, including transition. Only available
+   * when using Configuration::Schema::Json, returns false otherwise. The callbacks set with setOnOn(),
+   * setOnBrightness() and so on are called as well, for the fields present in the command.
+   */
+  bool setOnCommand(std::function<void(const Command &)> command_callback);
+
   /**
    * @brief Set callback for receiving callbacks when there is a new on state that should be set.
    */
@@ -205,7 +281,8 @@ public:
 
   /**
    * @brief Set callback for receiving callbacks when there is a new effect that should be set. Will only be
-   * respected if the light is setup with this capability.
+   * respected if the light is setup with this capability. Commands with an effect not in the Configuration are
+   * ignored.
    */
   bool setOnEffect(std::function<void(std::string)> effect_callback);
 
@@ -216,17 +293,38 @@ public:
   bool setOnRgb(std::function<void(RGB)> effect_callback);
 
 private:
-  std::string _name;
+  using CommandCallbacks = std::vector<std::function<void(const Command &)>>;
+
+  // The state topics, see stateTopic().
+  enum class StateTopic : uint8_t { OnOff, Brightness, ColorTemperature, Rgb, Effect, Json, Count };
+
+  bool isJsonSchema() const { return _configuration.schema == Configuration::Schema::Json; }
+  bool addCommandCallback(std::function<void(const Command &)> callback);
+  std::shared_ptr<const CommandCallbacks> loadCommandCallbacks();
+  void publishJsonState();
+  std::optional<std::string> jsonState() const; // With _lock held.
+  const std::string &stateTopic(StateTopic topic);
+  void republish(StateTopic topic);
+
+private:
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
-  Configuration _configuration;
+  homeassistantentities::InternedString _child_object_id;
+  Configuration _configuration; // Without the effects, these are in _effects.
+  homeassistantentities::OptionIndex _effects;
 
 private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
+  // Only with Schema::Json, shared by the one subscription. Replaced rather than changed when a callback is added, as
+  // the MQTT or dispatch task may be running the callbacks.
+  std::shared_ptr<const CommandCallbacks> _command_callbacks;
+  homeassistantentities::CachedTopics<static_cast<size_t>(StateTopic::Count)> _state_topics;
   std::optional<bool> _on;
   std::optional<RGB> _rgb;
-  std::optional<std::string> _effect;
+  std::optional<size_t> _effect; // Index in _effects.
   std::optional<uint8_t> _brightness;
   std::optional<uint16_t> _color_temperature;
+  bool _rgb_color_mode = true; // With Schema::Json, if RGB or color temperature was the last color set.
 };
 
 #endif // __HA_ENTITY_LIGHT_H__
\ No newline at end of file
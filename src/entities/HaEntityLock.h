@@ -42,6 +42,9 @@ public:
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the lock. This will publish to MQTT regardless if the value has changed. Also see
@@ -59,7 +62,7 @@ public:
   void updateLock(bool locked) { _ha_entity_sensor.updateValue(locked ? "OFF" : "ON"); } // locked == OFF
 
 private:
-  const homeassistantentities::BinarySensor::Lock _lock;
+  static constexpr homeassistantentities::BinarySensor::Lock _lock = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
@@ -1,19 +1,22 @@
 #include "HaEntityNumber.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 
 #define COMPONENT "number"
 
+using namespace homeassistantentities;
+
 HaEntityNumber::HaEntityNumber(HaBridge &ha_bridge, std::string name, std::string object_id,
                                Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _object_id(object_id),
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _object_id(object_id),
       _configuration(configuration) {}
 
 void HaEntityNumber::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -39,32 +42,57 @@ void HaEntityNumber::publishConfiguration() {
 }
 
 void HaEntityNumber::republishState() {
-  if (_number) {
-    publishNumber(*_number);
+  _ha_bridge.republishState(_lock, _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id),
+                            [this]() { return _number ? std::optional(std::to_string(*_number)) : std::nullopt; });
+}
+
+void HaEntityNumber::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id), [this](const std::string &message) {
+    char *end;
+    float number = std::strtof(message.c_str(), &end);
+    if (end != message.c_str() && *end == '\0') {
+      storeIfEmptyLocked(_lock, _number, number);
+    }
+  });
+}
+
+void HaEntityNumber::saveState(std::string &record) { StateRecordWriter(record).put(loadLocked(_lock, _number)); }
+
+bool HaEntityNumber::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<float> number;
+  reader.get(number);
+  if (!reader.ok()) {
+    return false;
   }
+  if (number) {
+    storeIfEmptyLocked(_lock, _number, *number);
+  }
+  return true;
 }
 
 void HaEntityNumber::publishNumber(float number) {
   // numbered == OFF
-  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id),
-                            std::to_string(number));
-  _number = number;
+  _ha_bridge.publishState(_lock, _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id),
+                          std::to_string(number), [&]() { _number = number; });
 }
 
 void HaEntityNumber::updateNumber(float number) {
-  if (!_number || *_number != number) {
+  if (auto cached = loadLocked(_lock, _number); !cached || *cached != number) {
     publishNumber(number);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Number);
   }
 }
 
 bool HaEntityNumber::setOnNumber(std::function<void(float)> callback) {
-  return _ha_bridge.remote().subscribe(_ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id),
-                                       [callback](std::string topic, std::string message) {
-                                         char *end;
-                                         float num = std::strtof(message.c_str(), &end);
-                                         if (end != message.c_str() && *end == '\0') {
-                                           callback(num);
-                                         }
-                                         // Invalid input, ignore
-                                       });
+  return _ha_bridge.subscribe(_ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id),
+                              [callback](std::string topic, std::string message) {
+                                char *end;
+                                float num = std::strtof(message.c_str(), &end);
+                                if (end != message.c_str() && *end == '\0') {
+                                  callback(num);
+                                }
+                                // Invalid input, ignore
+                              });
 }
\ No newline at end of file
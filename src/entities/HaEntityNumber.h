@@ -3,6 +3,8 @@
 
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -71,6 +73,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the number. This will publish to MQTT regardless if the value has changed. Also see
@@ -89,12 +94,13 @@ public:
   bool setOnNumber(std::function<void(float)> callback);
 
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _object_id;
+  homeassistantentities::InternedString _object_id;
   Configuration _configuration;
 
 private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
   std::optional<float> _number;
 };
 
@@ -1,19 +1,24 @@
 #include "HaEntitySelect.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 
 #define COMPONENT "select"
 
+using namespace homeassistantentities;
+
 HaEntitySelect::HaEntitySelect(HaBridge &ha_bridge, std::string name, std::string object_id,
                                Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _object_id(object_id),
-      _configuration(configuration) {}
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _object_id(object_id),
+      _configuration(configuration), _options(_configuration.options) {
+  _configuration.options.clear();
+}
 
 void HaEntitySelect::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -24,32 +29,103 @@ void HaEntitySelect::publishConfiguration() {
   doc["command_topic"] = _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id);
 
   JsonArrayType options_array = createJsonArray(doc, "options");
-  for (const std::string &option : _configuration.options) {
-    addToJsonArray(options_array, option);
+  for (size_t i = 0; i < _options.size(); i++) {
+    addToJsonArray(options_array, _options.at(i));
   }
 
   _ha_bridge.publishConfiguration(COMPONENT, _object_id, "", doc);
 }
 
 void HaEntitySelect::republishState() {
-  if (_selection) {
-    publishSelection(*_selection);
+  _ha_bridge.republishState(_lock, stateTopic(), [this]() -> std::optional<std::string_view> {
+    if (!_selection) {
+      return std::nullopt;
+    }
+    return _options.at(*_selection);
+  });
+}
+
+void HaEntitySelect::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id), [this](const std::string &message) {
+    if (auto index = _options.find(message)) {
+      storeIfEmptyLocked(_lock, _selection, *index);
+    }
+  });
+}
+
+void HaEntitySelect::saveState(std::string &record) {
+  // The option rather than its index, which changes if options are added or removed in a new firmware.
+  std::optional<std::string_view> option;
+  if (auto index = loadLocked(_lock, _selection)) {
+    option = _options.at(*index);
   }
+  StateRecordWriter(record).put(option);
 }
 
-void HaEntitySelect::publishSelection(std::string option) {
-  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id), option);
-  _selection = option;
+bool HaEntitySelect::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<std::string> option;
+  reader.get(option);
+  if (!reader.ok()) {
+    return false;
+  }
+  if (option) {
+    if (auto index = _options.find(*option)) {
+      storeIfEmptyLocked(_lock, _selection, *index);
+    }
+  }
+  return true;
+}
+
+std::optional<size_t> HaEntitySelect::indexOf(std::string_view option) const { return _options.find(option); }
+
+void HaEntitySelect::publishSelection(std::string_view option) {
+  if (auto index = _options.find(option)) {
+    publishSelection(*index);
+  }
 }
 
-void HaEntitySelect::updateSelection(std::string option) {
-  if (!_selection || *_selection != option) {
-    publishSelection(option);
+void HaEntitySelect::publishSelection(size_t index) {
+  if (index >= _options.size()) {
+    return;
+  }
+  _ha_bridge.publishState(_lock, stateTopic(), _options.at(index), [&]() { _selection = index; });
+}
+
+const std::string &HaEntitySelect::stateTopic() {
+  return _state_topic.get(_lock, [this]() {
+    return _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _object_id);
+  });
+}
+
+void HaEntitySelect::updateSelection(std::string_view option) {
+  if (auto index = _options.find(option)) {
+    updateSelection(*index);
+  }
+}
+
+void HaEntitySelect::updateSelection(size_t index) {
+  if (!equalsLocked(_lock, _selection, index)) {
+    publishSelection(index);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Select);
   }
 }
 
 bool HaEntitySelect::setOnSelected(std::function<void(std::string)> select_callback) {
-  return _ha_bridge.remote().subscribe(
-      _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id),
-      [select_callback](std::string topic, std::string message) { select_callback(message); });
+  return _ha_bridge.subscribe(_ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id),
+                              [this, select_callback](std::string topic, std::string message) {
+                                if (_options.find(message)) {
+                                  select_callback(std::move(message));
+                                }
+                              });
+}
+
+bool HaEntitySelect::setOnSelectedIndex(std::function<void(size_t)> select_callback) {
+  return _ha_bridge.subscribe(_ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _object_id),
+                              [this, select_callback](std::string topic, std::string message) {
+                                if (auto index = _options.find(message)) {
+                                  select_callback(*index);
+                                }
+                              });
 }
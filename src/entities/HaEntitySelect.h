@@ -2,12 +2,17 @@
 #define __HA_ENTITY_SELECT_H__
 
 #include <HaBridge.h>
+#include <HaCachedTopic.h>
 #include <HaEntity.h>
+#include <HaOptionIndex.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <functional>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Represent a Select that can be set by Home Assistant or reported back to Home Assistant.
@@ -17,7 +22,9 @@ class HaEntitySelect : public HaEntity {
 public:
   struct Configuration {
     /**
-     * @brief Set of options that can be selected. An empty set or a set with a single item is allowed.
+     * @brief Set of options that can be selected. An empty set or a set with a single item is allowed. Each option
+     * has an index, its position in the set (sorted order), which can be used instead of the option itself, see
+     * indexOf().
      */
     std::set<std::string> options;
 
@@ -46,36 +53,69 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
-   * @brief Publish the current selected option. Must be one of the options in the options list. This will publish to
-   * MQTT regardless if the value has changed. Also see updateSelection().
+   * @brief Get the index of an option, to use with the index overloads below. Looking up an option is a binary search
+   * over the options, so with many options it is cheaper to look up the index once and publish by index.
+   *
+   * @return the index, or std::nullopt if not one of the options.
+   */
+  std::optional<size_t> indexOf(std::string_view option) const;
+
+  /**
+   * @brief Publish the current selected option. Must be one of the options in the options list, other options are
+   * ignored. This will publish to MQTT regardless if the value has changed. Also see updateSelection().
    *
    * @param option the option selected.
    */
-  void publishSelection(std::string option);
+  void publishSelection(std::string_view option);
+
+  /**
+   * @brief Same as above, but with the index of the option (see indexOf()). Out of range indices are ignored.
+   */
+  void publishSelection(size_t index);
 
   /**
    * @brief Publish the current selected option, but only if the value has changed. Also see publishSelection(). Must be
-   * one of the options in the options list.
+   * one of the options in the options list, other options are ignored.
    *
    * @param option the option selected.
    */
-  void updateSelection(std::string option);
+  void updateSelection(std::string_view option);
 
   /**
-   * @brief Set callback for receiving callbacks when there is a new option that should be set.
+   * @brief Same as above, but with the index of the option (see indexOf()). Out of range indices are ignored.
+   */
+  void updateSelection(size_t index);
+
+  /**
+   * @brief Set callback for receiving callbacks when there is a new option that should be set. Commands with an option
+   * not in the options list are ignored.
    */
   bool setOnSelected(std::function<void(std::string)> select_callback);
 
+  /**
+   * @brief Same as above, but the callback gets the index of the option (see indexOf()).
+   */
+  bool setOnSelectedIndex(std::function<void(size_t)> select_callback);
+
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _object_id;
-  Configuration _configuration;
+  homeassistantentities::InternedString _object_id;
+  Configuration _configuration; // Without the options, these are in _options.
+  homeassistantentities::OptionIndex _options;
+
+private:
+  const std::string &stateTopic();
 
 private:
-  std::optional<std::string> _selection;
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
+  homeassistantentities::CachedTopic _state_topic;
+  std::optional<size_t> _selection; // Index in _options.
 };
 
 #endif // __HA_ENTITY_SELECT_H__
\ No newline at end of file
@@ -1,121 +1,223 @@
 #include "HaEntitySensor.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
+#include <mutex>
 
 using namespace homeassistantentities;
 
 HaEntitySensor::HaEntitySensor(HaBridge &ha_bridge, std::string name, std::optional<std::string> child_object_id,
                                Configuration configuration)
-    : _name(trim(name)), _ha_bridge(ha_bridge), _object_id(configuration.device_class.objectId()),
-      _configuration(configuration) {
-  _component = configuration.device_class.sensorType() == DeviceClass::SensorType::Sensor ? "sensor" : "binary_sensor";
-
+    : _ha_bridge(ha_bridge), _device_class(&configuration.device_class), _unit_of_measurement(0),
+      _with_attributes(configuration.with_attributes), _force_update(configuration.force_update),
+      _expire_after(configuration.expire_after) {
+  _strings[Name] = InternedString(trimView(name));
   if (child_object_id) {
-    auto coid = trim(*child_object_id);
-    _child_object_id = coid.empty() ? "" : coid;
-  } else {
-    _child_object_id = "";
+    _strings[ChildObjectId] = InternedString(trimView(*child_object_id));
+  }
+  if (configuration.state_class) {
+    _strings[StateClass] = InternedString(trimView(*configuration.state_class));
+  }
+  if (configuration.icon) {
+    _strings[Icon] = InternedString(*configuration.icon);
+  }
+  if (configuration.entity_category) {
+    _strings[EntityCategory] = InternedString(trimView(*configuration.entity_category));
+  }
+
+  auto unit = configuration.unit_of_measurement;
+  if (unit && *unit > 0 && *unit <= UINT8_MAX) {
+    _unit_of_measurement = static_cast<uint8_t>(*unit);
   }
 }
 
 void HaEntitySensor::publishConfiguration() {
   IJsonDocument doc;
 
-  if (!_name.empty()) {
-    doc["name"] = _name;
+  auto name = stringField(Name);
+  if (!name.empty()) {
+    doc["name"] = name;
   } else {
     doc["name"] = nullptr;
   }
-  doc["platform"] = _component; // we have validated this to be either sensor or binary_sensor
+  doc["platform"] = component();
 
-  if (_configuration.state_class) {
-    auto state_class = trim(*_configuration.state_class);
-    if (!state_class.empty()) {
-      doc["state_class"] = state_class;
-    }
+  auto state_class = stringField(StateClass);
+  if (!state_class.empty()) {
+    doc["state_class"] = state_class;
   }
-  auto device_class = _configuration.device_class.deviceClass();
+  auto device_class = _device_class->deviceClass();
   if (device_class) {
-    auto trimmed_device_class = trim(*device_class);
-    if (!trimmed_device_class.empty()) {
-      doc["device_class"] = trimmed_device_class;
-    }
+    doc["device_class"] = *device_class;
   }
-  if (_configuration.icon) {
-    doc["icon"] = *_configuration.icon;
+  auto icon = stringField(Icon);
+  if (!icon.empty()) {
+    doc["icon"] = icon;
+  }
+  auto entity_category = stringField(EntityCategory);
+  if (!entity_category.empty()) {
+    doc["entity_category"] = entity_category;
+  }
+  doc["force_update"] = static_cast<bool>(_force_update);
+  if (_expire_after > 0) {
+    doc["expire_after"] = _expire_after;
   }
-  doc["force_update"] = _configuration.force_update;
 
-  if (_configuration.unit_of_measurement) {
-    auto unit_of_measurement = _configuration.device_class.unitOfMeasurement(*_configuration.unit_of_measurement);
+  if (_unit_of_measurement > 0) {
+    auto unit_of_measurement = _device_class->unitOfMeasurement(_unit_of_measurement);
     if (unit_of_measurement) {
       doc["unit_of_measurement"] = *unit_of_measurement;
     }
   }
 
-  doc["state_topic"] = _ha_bridge.getTopic(HaBridge::TopicType::State, _component, _object_id, _child_object_id);
+  auto child_object_id = stringField(ChildObjectId);
+  doc["state_topic"] = _ha_bridge.getTopic(HaBridge::TopicType::State, component(), objectId(), child_object_id);
 
-  if (_configuration.with_attributes) {
+  if (_with_attributes) {
     doc["json_attributes_topic"] =
-        _ha_bridge.getTopic(HaBridge::TopicType::Attributes, _component, _object_id, _child_object_id);
+        _ha_bridge.getTopic(HaBridge::TopicType::Attributes, component(), objectId(), child_object_id);
   }
 
-  _ha_bridge.publishConfiguration(_component, _object_id, _child_object_id, doc);
+  _ha_bridge.publishConfiguration(component(), objectId(), child_object_id, doc);
 }
 
 void HaEntitySensor::republishState() {
-  if (_value) {
-    publishValue(*_value);
+  // From the cache under the lock, see HaBridge::republishState().
+  auto child_object_id = stringField(ChildObjectId);
+  _ha_bridge.republishState(_lock,
+                            _ha_bridge.getTopic(HaBridge::TopicType::State, component(), objectId(), child_object_id),
+                            [this]() { return _has_value ? std::optional<std::string>(_value) : std::nullopt; });
+  if (_with_attributes) {
+    _ha_bridge.republishState(
+        _lock, _ha_bridge.getTopic(HaBridge::TopicType::Attributes, component(), objectId(), child_object_id),
+        [this]() -> std::optional<std::string> {
+          IJsonDocument doc;
+          if (!_attributes || !Attributes::toJson(doc, *_attributes)) {
+            return std::nullopt;
+          }
+          return toJsonString(doc);
+        });
   }
-  if (_attributes) {
-    publishAttributes(*_attributes);
+}
+
+void HaEntitySensor::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, component(), objectId(), stringField(ChildObjectId)),
+      [this](const std::string &message) {
+        std::lock_guard<SpinLock> lock(_lock);
+        if (!_has_value) {
+          _value = message;
+          _has_value = true;
+        }
+      });
+}
+
+void HaEntitySensor::saveState(std::string &record) {
+  std::optional<std::string> value;
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    if (_has_value) {
+      value = _value;
+    }
   }
+  StateRecordWriter(record).put(value);
+}
+
+bool HaEntitySensor::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<std::string> value;
+  reader.get(value);
+  if (!reader.ok()) {
+    return false;
+  }
+  if (value) {
+    std::lock_guard<SpinLock> lock(_lock);
+    if (!_has_value) {
+      _value = std::move(*value);
+      _has_value = true;
+    }
+  }
+  return true;
 }
 
 void HaEntitySensor::publishValue(double value, Attributes::Map attributes) {
-  auto value_str = std::to_string(value);
-  publishValue(value_str, attributes);
+  publishValue(std::to_string(value), std::move(attributes));
 }
 
 void HaEntitySensor::publishValue(std::string value, Attributes::Map attributes) {
-  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, _component, _object_id, _child_object_id),
-                            value);
-  _value = value;
+  auto topic = _ha_bridge.getTopic(HaBridge::TopicType::State, component(), objectId(), stringField(ChildObjectId));
+  _ha_bridge.publishState(_lock, topic, value, [&]() {
+    _value = std::move(value);
+    _has_value = true;
+  });
 
   if (!attributes.empty()) {
-    publishAttributes(attributes);
+    publishAttributes(std::move(attributes));
   }
 }
 
 void HaEntitySensor::publishAttributes(Attributes::Map attributes) {
-  if (!_configuration.with_attributes) {
+  if (!_with_attributes) {
     return;
   }
-  _attributes = attributes;
+
+  auto store = [&]() {
+    if (_attributes) {
+      *_attributes = std::move(attributes);
+    } else {
+      _attributes = std::make_unique<Attributes::Map>(std::move(attributes));
+    }
+  };
 
   IJsonDocument doc;
-  if (Attributes::toJson(doc, attributes)) {
-    auto message = toJsonString(doc);
-    _ha_bridge.publishMessage(
-        _ha_bridge.getTopic(HaBridge::TopicType::Attributes, _component, _object_id, _child_object_id), message);
+  if (!Attributes::toJson(doc, attributes)) {
+    std::lock_guard<SpinLock> lock(_lock);
+    store();
+    return;
   }
+  auto topic =
+      _ha_bridge.getTopic(HaBridge::TopicType::Attributes, component(), objectId(), stringField(ChildObjectId));
+  _ha_bridge.publishState(_lock, topic, toJsonString(doc), store);
 }
 
 void HaEntitySensor::updateValue(double value, Attributes::Map attributes) {
-  auto value_str = std::to_string(value);
-  updateValue(value_str, attributes);
+  updateValue(std::to_string(value), std::move(attributes));
 }
 
 void HaEntitySensor::updateValue(std::string value, Attributes::Map attributes) {
-  if (!_value || *_value != value) {
-    publishValue(value, {});
+  bool changed;
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    changed = !_has_value || _value != value;
+  }
+  if (changed) {
+    publishValue(std::move(value), {});
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(metricsComponent());
   }
 
-  updateAttributes(attributes);
+  updateAttributes(std::move(attributes));
 }
 
 void HaEntitySensor::updateAttributes(Attributes::Map attributes) {
-  if (!_attributes || *_attributes != attributes) {
-    publishAttributes(attributes);
+  bool changed;
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    changed = !_attributes || *_attributes != attributes;
+  }
+  if (changed) {
+    publishAttributes(std::move(attributes));
+  } else if (_with_attributes && !attributes.empty()) {
+    _ha_bridge.metrics().recordDeduplicated(metricsComponent());
   }
-}
\ No newline at end of file
+}
+
+std::string_view HaEntitySensor::stringField(StringField field) const { return _strings[field].view(); }
+
+std::string_view HaEntitySensor::component() const {
+  return _device_class->sensorType() == DeviceClass::SensorType::Sensor ? "sensor" : "binary_sensor";
+}
+
+HaBridgeMetrics::Component HaEntitySensor::metricsComponent() const {
+  return _device_class->sensorType() == DeviceClass::SensorType::Sensor ? HaBridgeMetrics::Component::Sensor
+                                                                         : HaBridgeMetrics::Component::BinarySensor;
+}
@@ -5,9 +5,14 @@
 #include "HaDeviceClasses.h"
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 
 /**
  * @brief A generic sensor/binary sensor. Consider using any of the specific sensors first, like HaEntityTemperature,
@@ -51,6 +56,18 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received, up to 65535. 0
+     * for never (default). Republish the state within this time even if unchanged, see HaEntityRegistry::add().
+     */
+    uint16_t expire_after = 0;
+
+    /**
+     * @brief The entity category, "diagnostic" or "config". Set to "diagnostic" for sensors that report on the device
+     * itself rather than on what it measures, like the HaBridgeMetrics counters from HaBridge::metrics(). Default none.
+     */
+    std::optional<std::string> entity_category = std::nullopt;
   };
 
   /**
@@ -78,6 +95,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the value for this sensor. This will publish to MQTT regardless if the value has changed. Also see
@@ -130,16 +150,31 @@ public:
   void updateAttributes(Attributes::Map attributes);
 
 private:
-  std::string _name;
+  /**
+   * @brief The per-entity strings, interned in the homeassistantentities::stringPool(). The Configuration is not
+   * kept, only what is needed to publish the configuration and the state.
+   */
+  enum StringField : uint8_t { Name, ChildObjectId, StateClass, Icon, EntityCategory, NumStringFields };
+
+  std::string_view stringField(StringField field) const;
+  std::string_view objectId() const { return _device_class->objectId(); }
+  std::string_view component() const;
+  HaBridgeMetrics::Component metricsComponent() const;
+
+private:
   HaBridge &_ha_bridge;
-  std::string _object_id;
-  std::string _component;
-  std::string _child_object_id;
-  Configuration _configuration;
+  const homeassistantentities::DeviceClass *_device_class; // Static storage, from the Configuration.
+  std::array<homeassistantentities::InternedString, NumStringFields> _strings;
+  uint8_t _unit_of_measurement; // 0 for no unit (UnitType starts at 1).
+  bool _with_attributes : 1;
+  bool _force_update : 1;
+  uint16_t _expire_after; // In seconds, 0 for never.
 
 private:
-  std::optional<std::string> _value;
-  std::optional<Attributes::Map> _attributes;
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
+  bool _has_value = false;
+  std::string _value;
+  std::unique_ptr<Attributes::Map> _attributes; // Only allocated once attributes are published.
 };
 
 #endif // __HA_ENTITY_SENSOR_H__
\ No newline at end of file
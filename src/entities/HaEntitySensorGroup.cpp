@@ -0,0 +1,187 @@
+#include "HaEntitySensorGroup.h"
+#include <HaStateRecord.h>
+#include <HaUtilities.h>
+#include <IJson.h>
+#include <mutex>
+
+#define COMPONENT "sensor"
+#define OBJECT_ID "group"
+
+using namespace homeassistantentities;
+
+// Subscript rather than dot access, as the child object ID in the key can have characters like '-' or a leading digit
+// that Jinja does not allow in an attribute name.
+static std::string valueTemplate(std::string_view key) {
+  std::string value_template = "{{ value_json['";
+  for (auto c : key) {
+    if (c == '\\' || c == '\'') {
+      value_template += '\\';
+    }
+    value_template += c;
+  }
+  value_template += "'] }}";
+  return value_template;
+}
+
+HaEntitySensorGroup::HaEntitySensorGroup(HaBridge &ha_bridge, std::optional<std::string> child_object_id,
+                                         std::vector<Member> members)
+    : _ha_bridge(ha_bridge) {
+  if (child_object_id) {
+    _child_object_id = InternedString(trimView(*child_object_id));
+  }
+
+  _members.reserve(members.size());
+  for (const auto &member : members) {
+    MemberConfiguration configuration = {
+        .name = InternedString(trimView(member.name)),
+        .child_object_id = {},
+        .state_class = {},
+        .device_class = &member.device_class,
+        .unit_of_measurement = 0,
+    };
+    if (member.child_object_id) {
+      configuration.child_object_id = InternedString(trimView(*member.child_object_id));
+    }
+    if (member.state_class) {
+      configuration.state_class = InternedString(trimView(*member.state_class));
+    }
+    auto unit = member.unit_of_measurement;
+    if (unit && *unit > 0 && *unit <= UINT8_MAX) {
+      configuration.unit_of_measurement = static_cast<uint8_t>(*unit);
+    }
+    _members.push_back(configuration);
+  }
+}
+
+std::string HaEntitySensorGroup::key(size_t member) const {
+  if (member >= _members.size()) {
+    return "";
+  }
+  auto &configuration = _members[member];
+  std::string key(configuration.device_class->objectId());
+  if (!configuration.child_object_id.empty()) {
+    key += '_';
+    key += configuration.child_object_id.view();
+  }
+  return key;
+}
+
+void HaEntitySensorGroup::publishConfiguration() {
+  auto state_topic = _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id);
+
+  for (size_t i = 0; i < _members.size(); i++) {
+    auto &member = _members[i];
+    auto component =
+        member.device_class->sensorType() == DeviceClass::SensorType::Sensor ? "sensor" : "binary_sensor";
+
+    IJsonDocument doc;
+    if (!member.name.empty()) {
+      doc["name"] = member.name.view();
+    } else {
+      doc["name"] = nullptr;
+    }
+    doc["platform"] = component;
+
+    if (!member.state_class.empty()) {
+      doc["state_class"] = member.state_class.view();
+    }
+    auto device_class = member.device_class->deviceClass();
+    if (device_class) {
+      doc["device_class"] = *device_class;
+    }
+    if (member.unit_of_measurement > 0) {
+      auto unit_of_measurement = member.device_class->unitOfMeasurement(member.unit_of_measurement);
+      if (unit_of_measurement) {
+        doc["unit_of_measurement"] = *unit_of_measurement;
+      }
+    }
+
+    doc["state_topic"] = state_topic;
+    doc["value_template"] = valueTemplate(key(i));
+
+    _ha_bridge.publishConfiguration(component, member.device_class->objectId(), member.child_object_id, doc);
+  }
+}
+
+void HaEntitySensorGroup::republishState() {
+  // From the cache under the lock, see HaBridge::republishState().
+  _ha_bridge.republishState(_lock,
+                            _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id),
+                            [this]() { return valuesMessage(); });
+}
+
+void HaEntitySensorGroup::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id),
+      [this](const std::string &message) { restoreValues(message); });
+}
+
+void HaEntitySensorGroup::saveState(std::string &record) {
+  std::optional<std::string> message;
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    message = valuesMessage();
+  }
+  StateRecordWriter(record).put(message);
+}
+
+bool HaEntitySensorGroup::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<std::string> message;
+  reader.get(message);
+  if (!reader.ok()) {
+    return false;
+  }
+  return !message || restoreValues(*message);
+}
+
+void HaEntitySensorGroup::publishValues(Attributes::Map values) {
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    for (auto &value : values) {
+      _values[value.first] = std::move(value.second);
+    }
+  }
+  // The merged values, read again from the cache, so the message queued last has the values of all tasks.
+  republishState();
+}
+
+// Values as JSON, as published by valuesMessage(). Only kept if no values have been set yet.
+bool HaEntitySensorGroup::restoreValues(const std::string &message) {
+  IJsonDocument doc;
+  Attributes::Map values;
+  if (!parseJsonString(doc, message) || !Attributes::fromJson(doc, values)) {
+    return false;
+  }
+  std::lock_guard<SpinLock> lock(_lock);
+  if (_values.empty()) {
+    _values = std::move(values);
+  }
+  return true;
+}
+
+std::optional<std::string> HaEntitySensorGroup::valuesMessage() const {
+  IJsonDocument doc;
+  if (_values.empty() || !Attributes::toJson(doc, _values)) {
+    return std::nullopt;
+  }
+  return toJsonString(doc);
+}
+
+void HaEntitySensorGroup::updateValues(Attributes::Map values) {
+  bool changed = false;
+  {
+    std::lock_guard<SpinLock> lock(_lock);
+    for (auto &value : values) {
+      auto cached = _values.find(value.first);
+      if (cached == _values.end() || cached->second != value.second) {
+        changed = true;
+        break;
+      }
+    }
+  }
+  if (changed) {
+    publishValues(std::move(values));
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Sensor);
+  }
+}
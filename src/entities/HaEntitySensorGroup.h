@@ -0,0 +1,118 @@
+#ifndef __HA_ENTITY_SENSOR_GROUP_H__
+#define __HA_ENTITY_SENSOR_GROUP_H__
+
+#include "AttributeVariants.h"
+#include "HaDeviceClasses.h"
+#include <HaBridge.h>
+#include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Several sensors sharing one state topic, like all values read from one environmental sensor board. All values
+ * are published as one JSON object, and each sensor extracts its value with a value_template in its configuration. So
+ * one read of a board with 12 values is one message rather than 12.
+ *
+ * Each member shows up in Home Assistant as its own sensor, with the same unique ID as a HaEntitySensor (or
+ * HaEntityTemperature, HaEntityHumidity etc) with the same device class and child object ID would have. So existing
+ * sensors can be moved into a group without losing their history.
+ */
+class HaEntitySensorGroup : public HaEntity {
+public:
+  struct Member {
+    /**
+     * @brief The human readable name of this sensor. See HaEntitySensor.
+     */
+    std::string name;
+
+    /**
+     * @brief Optional child object ID, needed if there are several members with the same device class. See
+     * HaEntitySensor.
+     */
+    std::optional<std::string> child_object_id = std::nullopt;
+
+    /**
+     * @brief The Device class to use. One of the classes in HaDeviceClasses.h. Must have static storage duration.
+     */
+    const homeassistantentities::DeviceClass &device_class;
+
+    /**
+     * @brief The unit of measurement to use from the sensor. Should be a unit provided by the Device class, or
+     * std::nullopt if no unit.
+     */
+    std::optional<homeassistantentities::UnitType> unit_of_measurement = std::nullopt;
+
+    /**
+     * @brief The state class to use for this sensor. See
+     * https://developers.home-assistant.io/docs/core/entity/sensor/#available-state-classes
+     */
+    std::optional<std::string> state_class = "measurement";
+  };
+
+  /**
+   * @brief Construct a new Ha Entity Sensor Group object
+   *
+   * @param child_object_id optional child identifier in case there are several groups for the same node ID. Valid
+   * characters are [a-zA-Z0-9_-] (machine readable, not human readable)
+   * @param members the sensors in this group. The key for each member in publishValues() is the object ID of the
+   * device class (like "temperature"), followed by "_" and the child object ID if set (like "temperature_inside").
+   */
+  HaEntitySensorGroup(HaBridge &ha_bridge, std::optional<std::string> child_object_id, std::vector<Member> members);
+
+public:
+  void publishConfiguration() override;
+  void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
+
+  /**
+   * @brief Publish values for the members. This will publish to MQTT regardless if the values have changed. Also see
+   * updateValues(). Values not in this call keep their last value, so every message has all values published so far.
+   *
+   * @param values the values, by member key (see constructor). Use "ON" and "OFF" for binary sensors.
+   */
+  void publishValues(Attributes::Map values);
+
+  /**
+   * @brief Publish values for the members, but only if any value has changed. Also see publishValues().
+   *
+   * @param values the values, by member key (see constructor). Use "ON" and "OFF" for binary sensors.
+   */
+  void updateValues(Attributes::Map values);
+
+  /**
+   * @brief The key for a member in publishValues().
+   *
+   * @param member index of the member, as given in the constructor.
+   */
+  std::string key(size_t member) const;
+
+private:
+  struct MemberConfiguration {
+    homeassistantentities::InternedString name;
+    homeassistantentities::InternedString child_object_id;
+    homeassistantentities::InternedString state_class;
+    const homeassistantentities::DeviceClass *device_class; // Static storage, from the Member.
+    uint8_t unit_of_measurement;                           // 0 for no unit (UnitType starts at 1).
+  };
+
+private:
+  std::optional<std::string> valuesMessage() const; // With _lock held.
+  bool restoreValues(const std::string &message);
+
+private:
+  HaBridge &_ha_bridge;
+  homeassistantentities::InternedString _child_object_id;
+  std::vector<MemberConfiguration> _members;
+
+private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
+  Attributes::Map _values;
+};
+
+#endif // __HA_ENTITY_SENSOR_GROUP_H__
@@ -29,9 +29,14 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = {.unit = Unit::dBm, .force_update = false};
+  inline static Configuration _default = {.unit = Unit::dBm, .force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity SignalStrength object
@@ -60,11 +65,15 @@ public:
                                              .device_class = _signal_strength,
                                              .unit_of_measurement = configuration.unit,
                                              .force_update = configuration.force_update,
+                                             .expire_after = configuration.expire_after,
                                          })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the signal strength. This will publish to MQTT regardless if the value has changed. Also see
@@ -82,7 +91,7 @@ public:
   void updateSignalStrength(double signal_strength) { _ha_entity_sensor.updateValue(signal_strength); }
 
 private:
-  const homeassistantentities::Sensor::SignalStrength _signal_strength;
+  static constexpr homeassistantentities::Sensor::SignalStrength _signal_strength = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
@@ -0,0 +1,88 @@
+#include "HaEntitySizes.h"
+#include "HaEntityAtmosphericPressure.h"
+#include "HaEntityBoolean.h"
+#include "HaEntityBrightness.h"
+#include "HaEntityButton.h"
+#include "HaEntityCarbonDioxide.h"
+#include "HaEntityCover.h"
+#include "HaEntityCurrent.h"
+#include "HaEntityDeviceTrigger.h"
+#include "HaEntityDiagnostics.h"
+#include "HaEntityDoor.h"
+#include "HaEntityEvent.h"
+#include "HaEntityFan.h"
+#include "HaEntityHumidity.h"
+#include "HaEntityJson.h"
+#include "HaEntityLight.h"
+#include "HaEntityLock.h"
+#include "HaEntityMotion.h"
+#include "HaEntityNumber.h"
+#include "HaEntityParticulateMatter.h"
+#include "HaEntityPower.h"
+#include "HaEntitySelect.h"
+#include "HaEntitySensor.h"
+#include "HaEntitySensorGroup.h"
+#include "HaEntitySignalStrength.h"
+#include "HaEntitySound.h"
+#include "HaEntityString.h"
+#include "HaEntitySwitch.h"
+#include "HaEntityTemperature.h"
+#include "HaEntityText.h"
+#include "HaEntityTimestamp.h"
+#include "HaEntityUnitConcentration.h"
+#include "HaEntityVolatileOrganicCompounds.h"
+#include "HaEntityVoltage.h"
+#include "HaEntityWeight.h"
+
+// Budget for a 32 bit target. Pointers and std::string are larger on 64 bit hosts, so just allow twice as much there.
+#define BUDGET(bytes) (sizeof(void *) == 4 ? (bytes) : 2 * (bytes))
+
+namespace homeassistantentities {
+
+template <typename T, size_t BUDGET_BYTES> constexpr EntitySize entitySize(const char *name) {
+  static_assert(sizeof(T) <= BUDGET_BYTES, "Entity is larger than its RAM budget in HaEntitySizes.cpp");
+  return EntitySize{.name = name, .size = sizeof(T), .budget = BUDGET_BYTES};
+}
+
+#define ENTITY_SIZE(T, bytes) entitySize<T, BUDGET(bytes)>(#T)
+
+const EntitySize ENTITY_SIZES[] = {
+    ENTITY_SIZE(HaEntityAtmosphericPressure, 64),
+    ENTITY_SIZE(HaEntityBoolean, 64),
+    ENTITY_SIZE(HaEntityBrightness, 64),
+    ENTITY_SIZE(HaEntityButton, 32),
+    ENTITY_SIZE(HaEntityCarbonDioxide, 64),
+    ENTITY_SIZE(HaEntityCover, 64),
+    ENTITY_SIZE(HaEntityCurrent, 64),
+    ENTITY_SIZE(HaEntityDeviceTrigger, 64),
+    ENTITY_SIZE(HaEntityDiagnostics, 448),
+    ENTITY_SIZE(HaEntityDoor, 64),
+    ENTITY_SIZE(HaEntityEvent, 64),
+    ENTITY_SIZE(HaEntityFan, 144),
+    ENTITY_SIZE(HaEntityHumidity, 64),
+    ENTITY_SIZE(HaEntityJson, 64),
+    ENTITY_SIZE(HaEntityLight, 112),
+    ENTITY_SIZE(HaEntityLock, 64),
+    ENTITY_SIZE(HaEntityMotion, 64),
+    ENTITY_SIZE(HaEntityNumber, 96),
+    ENTITY_SIZE(HaEntityParticulateMatter, 64),
+    ENTITY_SIZE(HaEntityPower, 64),
+    ENTITY_SIZE(HaEntitySelect, 80),
+    ENTITY_SIZE(HaEntitySensor, 64),
+    ENTITY_SIZE(HaEntitySensorGroup, 64),
+    ENTITY_SIZE(HaEntitySignalStrength, 64),
+    ENTITY_SIZE(HaEntitySound, 64),
+    ENTITY_SIZE(HaEntityString, 64),
+    ENTITY_SIZE(HaEntitySwitch, 32),
+    ENTITY_SIZE(HaEntityTemperature, 64),
+    ENTITY_SIZE(HaEntityText, 64),
+    ENTITY_SIZE(HaEntityTimestamp, 64),
+    ENTITY_SIZE(HaEntityUnitConcentration, 64),
+    ENTITY_SIZE(HaEntityVolatileOrganicCompounds, 64),
+    ENTITY_SIZE(HaEntityVoltage, 64),
+    ENTITY_SIZE(HaEntityWeight, 64),
+};
+
+const size_t NUM_ENTITY_SIZES = sizeof(ENTITY_SIZES) / sizeof(ENTITY_SIZES[0]);
+
+} // namespace homeassistantentities
@@ -0,0 +1,27 @@
+#ifndef __HA_ENTITY_SIZES_H__
+#define __HA_ENTITY_SIZES_H__
+
+#include <cstddef>
+
+namespace homeassistantentities {
+
+/**
+ * @brief The RAM used by one instance of an entity type, as given by sizeof(). Heap allocations done by the entity,
+ * like names longer than the small string buffer or published attributes, are not included.
+ */
+struct EntitySize {
+  const char *name;
+  size_t size;
+  size_t budget; // The size is asserted at compile time to be at most this.
+};
+
+/**
+ * @brief Size report for all entity types, NUM_ENTITY_SIZES entries. Useful to estimate how many entities fit on a
+ * node. Budgets are in bytes for 32 bit targets (ESP32 and ESP8266), and doubled on 64 bit hosts.
+ */
+extern const EntitySize ENTITY_SIZES[];
+extern const size_t NUM_ENTITY_SIZES;
+
+} // namespace homeassistantentities
+
+#endif // __HA_ENTITY_SIZES_H__
@@ -42,6 +42,9 @@ public:
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the sound. This will publish to MQTT regardless if the value has changed. Also see
@@ -59,7 +62,7 @@ public:
   void updateSound(bool detected) { _ha_entity_sensor.updateValue(detected ? "ON" : "OFF"); }
 
 private:
-  const homeassistantentities::BinarySensor::Sound _sound;
+  static constexpr homeassistantentities::BinarySensor::Sound _sound = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
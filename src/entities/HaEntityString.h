@@ -28,9 +28,14 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = {.with_attributes = false, .force_update = false};
+  inline static Configuration _default = {.with_attributes = false, .force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity String object
@@ -59,11 +64,15 @@ public:
                                              .state_class = std::nullopt,
                                              .with_attributes = configuration.with_attributes,
                                              .force_update = configuration.force_update,
+                                             .expire_after = configuration.expire_after,
                                          })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the string. This will publish to MQTT regardless if the string has changed. Also see
@@ -73,7 +82,7 @@ public:
    * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
    */
   void publishString(std::string str, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.publishValue(str, attributes);
+    _ha_entity_sensor.publishValue(std::move(str), std::move(attributes));
   }
 
   /**
@@ -83,7 +92,7 @@ public:
    * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
    */
   void updateString(std::string str, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.updateValue(str, attributes);
+    _ha_entity_sensor.updateValue(std::move(str), std::move(attributes));
   }
 
   /**
@@ -91,10 +100,10 @@ public:
    *
    * @param attributes
    */
-  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(attributes); }
+  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(std::move(attributes)); }
 
 private:
-  const homeassistantentities::Sensor::Undefined::String _string;
+  static constexpr homeassistantentities::Sensor::Undefined::String _string = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
@@ -1,4 +1,5 @@
 #include "HaEntitySwitch.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 
@@ -6,18 +7,20 @@
 #define OBJECT_ID "switch"
 #define OBJECT_ID_ONOFF "onoff"
 
+using namespace homeassistantentities;
+
 // NOTE! We have swapped object ID and child object ID to get a nicer state/command topic path.
 
 HaEntitySwitch::HaEntitySwitch(HaBridge &ha_bridge, std::string name, std::string child_object_id,
                                Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
       _configuration(configuration) {}
 
 void HaEntitySwitch::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -32,26 +35,58 @@ void HaEntitySwitch::publishConfiguration() {
 }
 
 void HaEntitySwitch::republishState() {
-  if (_on) {
-    publishSwitch(*_on);
+  _ha_bridge.republishState(_lock, stateTopic(), [this]() -> std::optional<std::string_view> {
+    if (!_on) {
+      return std::nullopt;
+    }
+    return *_on ? PAYLOAD_ON : PAYLOAD_OFF;
+  });
+}
+
+void HaEntitySwitch::restoreState(const StateRestorer &add) {
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
+      [this](const std::string &message) {
+        if (message == PAYLOAD_ON || message == PAYLOAD_OFF) {
+          storeIfEmptyLocked(_lock, _on, message == PAYLOAD_ON);
+        }
+      });
+}
+
+void HaEntitySwitch::saveState(std::string &record) { StateRecordWriter(record).put(loadLocked(_lock, _on)); }
+
+bool HaEntitySwitch::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<bool> on;
+  reader.get(on);
+  if (!reader.ok()) {
+    return false;
+  }
+  if (on) {
+    storeIfEmptyLocked(_lock, _on, *on);
   }
+  return true;
+}
+
+const std::string &HaEntitySwitch::stateTopic() {
+  return _state_topic.get(_lock, [this]() {
+    return _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF);
+  });
 }
 
 void HaEntitySwitch::publishSwitch(bool on) {
-  _ha_bridge.publishMessage(
-      _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
-      std::string(on ? "ON" : "OFF"));
-  _on = on;
+  _ha_bridge.publishState(_lock, stateTopic(), on ? PAYLOAD_ON : PAYLOAD_OFF, [&]() { _on = on; });
 }
 
 void HaEntitySwitch::updateSwitch(bool on) {
-  if (!_on || *_on != on) {
+  if (auto cached = loadLocked(_lock, _on); !cached || *cached != on) {
     publishSwitch(on);
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Switch);
   }
 }
 
 bool HaEntitySwitch::setOnState(std::function<void(bool)> state_callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_ONOFF),
       [state_callback](std::string topic, std::string message) { state_callback(message == "ON"); });
 }
@@ -2,7 +2,10 @@
 #define __HA_ENTITY_SWITCH_H__
 
 #include <HaBridge.h>
+#include <HaCachedTopic.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -48,6 +51,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the switch state This will publish to MQTT regardless if the state has changed. Also see
@@ -70,13 +76,18 @@ public:
   bool setOnState(std::function<void(bool)> state_callback);
 
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
+  homeassistantentities::InternedString _child_object_id;
   Configuration _configuration;
 
 private:
+  const std::string &stateTopic();
+
+private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
   std::optional<bool> _on;
+  homeassistantentities::CachedTopic _state_topic;
 };
 
 #endif // __HA_ENTITY_SWITCH_H__
\ No newline at end of file
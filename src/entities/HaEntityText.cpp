@@ -1,4 +1,5 @@
 #include "HaEntityText.h"
+#include <HaStateRecord.h>
 #include <HaUtilities.h>
 #include <IJson.h>
 
@@ -6,16 +7,18 @@
 #define OBJECT_ID "text"
 #define OBJECT_ID_TEXT "text"
 
+using namespace homeassistantentities;
+
 HaEntityText::HaEntityText(HaBridge &ha_bridge, std::string name, std::string child_object_id,
                            Configuration configuration)
-    : _name(homeassistantentities::trim(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
+    : _name(homeassistantentities::trimView(name)), _ha_bridge(ha_bridge), _child_object_id(child_object_id),
       _configuration(configuration) {}
 
 void HaEntityText::publishConfiguration() {
   IJsonDocument doc;
 
   if (!_name.empty()) {
-    doc["name"] = _name;
+    doc["name"] = _name.view();
   } else {
     doc["name"] = nullptr;
   }
@@ -41,28 +44,56 @@ void HaEntityText::publishConfiguration() {
 }
 
 void HaEntityText::republishState() {
-  if (_str) {
-    publishText(*_str);
+  if (!_configuration.with_state_topic) {
+    return;
+  }
+  _ha_bridge.republishState(_lock,
+                            _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id),
+                            [this]() { return _str; });
+}
+
+void HaEntityText::restoreState(const StateRestorer &add) {
+  if (!_configuration.with_state_topic) {
+    return;
   }
+  add(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id),
+      [this](const std::string &message) { storeIfEmptyLocked(_lock, _str, message); });
+}
+
+void HaEntityText::saveState(std::string &record) { StateRecordWriter(record).put(loadLocked(_lock, _str)); }
+
+bool HaEntityText::loadState(std::string_view record) {
+  StateRecordReader reader(record);
+  std::optional<std::string> str;
+  reader.get(str);
+  if (!reader.ok()) {
+    return false;
+  }
+  if (str) {
+    storeIfEmptyLocked(_lock, _str, std::move(*str));
+  }
+  return true;
 }
 
 void HaEntityText::publishText(std::string str) {
   if (!_configuration.with_state_topic) {
     return;
   }
-  _str = str;
-  _ha_bridge.publishMessage(_ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id),
-                            str);
+  _ha_bridge.publishState(_lock,
+                          _ha_bridge.getTopic(HaBridge::TopicType::State, COMPONENT, OBJECT_ID, _child_object_id), str,
+                          [&]() { _str = std::move(str); });
 }
 
 void HaEntityText::updateText(std::string str) {
-  if (!_str || *_str != str) {
-    publishText(str);
+  if (!equalsLocked(_lock, _str, str)) {
+    publishText(std::move(str));
+  } else {
+    _ha_bridge.metrics().recordDeduplicated(HaBridgeMetrics::Component::Text);
   }
 }
 
 bool HaEntityText::setOnText(std::function<void(std::string)> callback) {
-  return _ha_bridge.remote().subscribe(
+  return _ha_bridge.subscribe(
       _ha_bridge.getTopic(HaBridge::TopicType::Command, COMPONENT, _child_object_id, OBJECT_ID_TEXT),
-      [callback](std::string topic, std::string message) { callback(message); });
+      [callback](std::string topic, std::string message) { callback(std::move(message)); });
 }
\ No newline at end of file
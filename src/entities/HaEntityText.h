@@ -3,6 +3,8 @@
 
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaSpinLock.h>
+#include <HaStringPool.h>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -79,6 +81,9 @@ public:
 public:
   void publishConfiguration() override;
   void republishState() override;
+  void restoreState(const StateRestorer &add) override;
+  void saveState(std::string &record) override;
+  bool loadState(std::string_view record) override;
 
   /**
    * @brief Publish the text. This will publish to MQTT regardless if the text has changed. Also see
@@ -105,12 +110,13 @@ public:
   bool setOnText(std::function<void(std::string)> callback);
 
 private:
-  std::string _name;
+  homeassistantentities::InternedString _name;
   HaBridge &_ha_bridge;
-  std::string _child_object_id;
+  homeassistantentities::InternedString _child_object_id;
   Configuration _configuration;
 
 private:
+  homeassistantentities::SpinLock _lock; // For the state below, which can be updated from any task.
   std::optional<std::string> _str;
 };
 
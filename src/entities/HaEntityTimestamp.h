@@ -4,6 +4,8 @@
 #include "HaEntitySensor.h"
 #include <HaBridge.h>
 #include <HaEntity.h>
+#include <HaTimestampFormat.h>
+#include <chrono>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -26,9 +28,21 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
+
+    /**
+     * @brief The offset from UTC, in minutes, for timestamps published as time since the epoch. Home Assistant shows
+     * timestamps in its own time zone, so UTC is usually fine.
+     */
+    int16_t utc_offset_minutes = 0;
   };
 
-  inline static Configuration _default = {.with_attributes = false, .force_update = false};
+  inline static Configuration _default = {
+      .with_attributes = false, .force_update = false, .expire_after = 0, .utc_offset_minutes = 0};
 
   /**
    * @brief Construct a new Ha Entity Timestamp object
@@ -59,11 +73,16 @@ public:
                                              .state_class = std::nullopt,
                                              .with_attributes = configuration.with_attributes,
                                              .force_update = configuration.force_update,
-                                         })) {}
+                                             .expire_after = configuration.expire_after,
+                                         })),
+        _utc_offset_minutes(configuration.utc_offset_minutes) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
   /**
    * @brief Publish the timestamp. This will publish to MQTT regardless if the string has changed. Also see
    * updateTimestamp().
@@ -74,7 +93,7 @@ public:
   void publishTimestamp(const struct tm *time, Attributes::Map attributes = {}) {
     char buf[27];
     strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", time);
-    publishTimestamp(std::string(buf), attributes);
+    publishTimestamp(std::string(buf), std::move(attributes));
   }
 
   /**
@@ -85,7 +104,41 @@ public:
    * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
    */
   void publishTimestamp(std::string time, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.publishValue(time, attributes);
+    _ha_entity_sensor.publishValue(std::move(time), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp, with second precision. This will publish to MQTT regardless if the timestamp has
+   * changed. Also see updateTimestamp(). Cheaper than the struct tm version, see
+   * homeassistantentities::formatTimestamp().
+   *
+   * @param since_epoch the timestamp to publish, as time since the Unix epoch.
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void publishTimestamp(std::chrono::seconds since_epoch, Attributes::Map attributes = {}) {
+    publishTimestamp(format(since_epoch, false), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp, with millisecond precision. This will publish to MQTT regardless if the timestamp has
+   * changed. Also see updateTimestamp().
+   *
+   * @param since_epoch the timestamp to publish, as time since the Unix epoch.
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void publishTimestamp(std::chrono::milliseconds since_epoch, Attributes::Map attributes = {}) {
+    publishTimestamp(format(since_epoch, true), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp, with second precision. This will publish to MQTT regardless if the timestamp has
+   * changed. Also see updateTimestamp().
+   *
+   * @param time the timestamp to publish, like std::chrono::system_clock::now().
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void publishTimestamp(std::chrono::system_clock::time_point time, Attributes::Map attributes = {}) {
+    publishTimestamp(std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()), std::move(attributes));
   }
 
   /**
@@ -98,7 +151,7 @@ public:
   void updateTimestamp(const struct tm *time, Attributes::Map attributes = {}) {
     char buf[27];
     strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", time);
-    _ha_entity_sensor.updateValue(std::string(buf), attributes);
+    _ha_entity_sensor.updateValue(std::string(buf), std::move(attributes));
   }
 
   /**
@@ -109,7 +162,40 @@ public:
    */
 
   void updateTimestamp(std::string time, Attributes::Map attributes = {}) {
-    _ha_entity_sensor.updateValue(time, attributes);
+    _ha_entity_sensor.updateValue(std::move(time), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp with second precision, but only if the timestamp has changed. Also see
+   * publishTimestamp().
+   *
+   * @param since_epoch the timestamp to publish, as time since the Unix epoch.
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void updateTimestamp(std::chrono::seconds since_epoch, Attributes::Map attributes = {}) {
+    _ha_entity_sensor.updateValue(format(since_epoch, false), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp with millisecond precision, but only if the timestamp has changed. Also see
+   * publishTimestamp().
+   *
+   * @param since_epoch the timestamp to publish, as time since the Unix epoch.
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void updateTimestamp(std::chrono::milliseconds since_epoch, Attributes::Map attributes = {}) {
+    _ha_entity_sensor.updateValue(format(since_epoch, true), std::move(attributes));
+  }
+
+  /**
+   * @brief Publish the timestamp with second precision, but only if the timestamp has changed. Also see
+   * publishTimestamp().
+   *
+   * @param time the timestamp to publish, like std::chrono::system_clock::now().
+   * @param attributes optional attributes to send with the string. with_attributes in constructor must be set.
+   */
+  void updateTimestamp(std::chrono::system_clock::time_point time, Attributes::Map attributes = {}) {
+    updateTimestamp(std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()), std::move(attributes));
   }
 
   /**
@@ -117,11 +203,17 @@ public:
    *
    * @param attributes
    */
-  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(attributes); }
+  void publishAttributes(Attributes::Map attributes) { _ha_entity_sensor.publishAttributes(std::move(attributes)); }
+
+private:
+  std::string format(std::chrono::milliseconds since_epoch, bool with_milliseconds) {
+    return homeassistantentities::formatTimestamp(since_epoch.count(), with_milliseconds, _utc_offset_minutes);
+  }
 
 private:
-  const homeassistantentities::Sensor::Timestamp _timestamp;
+  static constexpr homeassistantentities::Sensor::Timestamp _timestamp = {};
   HaEntitySensor _ha_entity_sensor;
+  int16_t _utc_offset_minutes;
 };
 
 #endif // __HA_ENTITY_TIMESTAMP_H__
\ No newline at end of file
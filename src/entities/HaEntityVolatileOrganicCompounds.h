@@ -32,9 +32,14 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = {.unit = Unit::Parts, .force_update = false};
+  inline static Configuration _default = {.unit = Unit::Parts, .force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity volatile organic compounds object
@@ -63,11 +68,15 @@ public:
                                              .device_class = deviceClass(configuration),
                                              .unit_of_measurement = unitOfMeasurement(configuration),
                                              .force_update = configuration.force_update,
+                                             .expire_after = configuration.expire_after,
                                          })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the volatile organic compounds concentration or parts, depending on Unit selected in configuration.
@@ -107,8 +116,8 @@ private:
   }
 
 private:
-  const homeassistantentities::Sensor::VolatileOrganicCompounds _volatile_organic_compounds;
-  const homeassistantentities::Sensor::VolatileOrganicCompoundsParts _volatile_organic_compounds_parts;
+  static constexpr homeassistantentities::Sensor::VolatileOrganicCompounds _volatile_organic_compounds = {};
+  static constexpr homeassistantentities::Sensor::VolatileOrganicCompoundsParts _volatile_organic_compounds_parts = {};
   HaEntitySensor _ha_entity_sensor;
 };
 
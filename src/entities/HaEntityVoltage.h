@@ -28,9 +28,14 @@ public:
      * message (not only when the sensor’s new state is different to the current one).
      */
     bool force_update = false;
+
+    /**
+     * @brief Seconds after which Home Assistant marks the sensor unavailable if no state was received. 0 for never.
+     */
+    uint16_t expire_after = 0;
   };
 
-  inline static Configuration _default = {.unit = Unit::V, .force_update = false};
+  inline static Configuration _default = {.unit = Unit::V, .force_update = false, .expire_after = 0};
 
   /**
    * @brief Construct a new Ha Entity Voltage object
@@ -58,11 +63,15 @@ public:
                                              .device_class = _voltage,
                                              .unit_of_measurement = configuration.unit,
                                              .force_update = configuration.force_update,
+                                             .expire_after = configuration.expire_after,
                                          })) {}
 
 public:
   void publishConfiguration() override { _ha_entity_sensor.publishConfiguration(); }
   void republishState() override { _ha_entity_sensor.republishState(); }
+  void restoreState(const StateRestorer &add) override { _ha_entity_sensor.restoreState(add); }
+  void saveState(std::string &record) override { _ha_entity_sensor.saveState(record); }
+  bool loadState(std::string_view record) override { return _ha_entity_sensor.loadState(record); }
 
   /**
    * @brief Publish the voltage. This will publish to MQTT regardless if the value has changed. Also see
@@ -80,7 +89,7 @@ public:
   void updateVoltage(double voltage) { _ha_entity_sensor.updateValue(voltage); }
 
 private:
-  const homeassistantentities::Sensor::Voltage _voltage;
+  static constexpr homeassistantentities::Sensor::Voltage _voltage = {};
   HaEntitySensor _ha_entity_sensor;
 };
 